@@ -1,6 +1,8 @@
 #ifndef BIPARTITE_H
 #define BIPARTITE_H
 #include "graph.h"
+#include <algorithm>
+#include <limits>
 #include <tr2/dynamic_bitset>
 
 template <typename Graph>
@@ -32,4 +34,133 @@ struct hungarian {
     std::vector<Vertex> matched_with;
 };
 
+/*
+* Hopcroft-Karp on the same input as hungarian: every vertex u is a left vertex with edges to right vertices,
+* matched_with[right] is the left vertex matched to it; every phase layers the left vertices by a bfs from the free ones,
+* then augments along vertex disjoint shortest paths by a dfs with an explicit stack and the current edge of every vertex,
+* a left vertex without a way on is removed from the layers; greedy starts from a maximal matching
+*/
+template <typename Graph>
+struct hopcroft_karp {
+    using Vertex = typename Graph::vertex;
+    using Iterator = decltype(std::declval<const Graph&>()[0].begin());
+    static constexpr int unreached = std::numeric_limits<int>::max();
+    hopcroft_karp(const Graph& g)
+    : graph(g), matched_with(g.size(), lcf::graph::nvtx), mate(g.size(), lcf::graph::nvtx), layer(g.size()), useful(g.size()) { }
+    size_t maximum_cardinality(bool greedy = true) {
+        size_t max_cnt = 0;
+        Vertex n = graph.size();
+        if (greedy) {
+            for (Vertex u = 0; u < n; ++u) {
+                for (const auto& edge : graph[u]) {
+                    if (matched_with[edge.head()] != lcf::graph::nvtx) { continue; }
+                    matched_with[edge.head()] = u; mate[u] = edge.head(); ++max_cnt;
+                    break;
+                }
+            }
+        }
+        while (bfs()) {
+            for (Vertex u = 0; u < n; ++u) { useful[u] = graph[u].begin(); }
+            for (Vertex u = 0; u < n; ++u) { if (mate[u] == lcf::graph::nvtx and dfs(u)) { ++max_cnt; } }
+        }
+        return max_cnt;
+    }
+    //* layers end with the first layer that has an edge to a free right vertex
+    bool bfs() {
+        queue.clear();
+        for (Vertex u = 0, n = graph.size(); u < n; ++u) {
+            if (mate[u] == lcf::graph::nvtx) { layer[u] = 0; queue.emplace_back(u); }
+            else { layer[u] = unreached; }
+        }
+        free_layer = unreached;
+        for (size_t front = 0; front < queue.size(); ++front) {
+            Vertex vtx = queue[front];
+            if (layer[vtx] >= free_layer) { break; }
+            for (const auto& edge : graph[vtx]) {
+                Vertex next = matched_with[edge.head()];
+                if (next == lcf::graph::nvtx) { free_layer = layer[vtx]; }
+                else if (layer[next] == unreached) { layer[next] = layer[vtx] + 1; queue.emplace_back(next); }
+            }
+        }
+        return free_layer != unreached;
+    }
+    bool dfs(Vertex root) {
+        stack.assign(1, root);
+        while (not stack.empty()) {
+            Vertex vtx = stack.back();
+            auto& iter = useful[vtx];
+            for (auto end = graph[vtx].end(); iter != end; ++iter) {
+                Vertex next = matched_with[(*iter).head()];
+                if (next == lcf::graph::nvtx ? layer[vtx] == free_layer : layer[vtx] < free_layer and layer[next] == layer[vtx] + 1) { break; }
+            }
+            if (not (iter != graph[vtx].end())) { layer[vtx] = unreached; stack.pop_back(); continue; }
+            Vertex next = matched_with[(*iter).head()];
+            if (next != lcf::graph::nvtx) { stack.emplace_back(next); continue; }
+            for (auto u : stack) { mate[u] = (*useful[u]).head(); matched_with[mate[u]] = u; }
+            return true;
+        }
+        return false;
+    }
+    const Graph& graph;
+    std::vector<Vertex> matched_with, mate;
+    std::vector<int> layer;
+    std::vector<Iterator> useful;
+    std::vector<Vertex> queue, stack;
+    int free_layer;
+};
+
+/*
+* Kuhn-Munkres for the minimum cost assignment of every row of a cost matrix to a distinct column in O(n^2 m),
+* the matrix is am::graph or lcf::matrix with no more rows than columns; rows are added one at a time and
+* the cheapest column under row and column potentials is found by dijkstra over dense rows with slack (minv);
+* the row and column scans have no branches and run over contiguous arrays, so they vectorize;
+* matched_with[column] is the row assigned to it, nvtx if none
+*/
+template <typename Matrix>
+struct kuhn_munkres {
+    using Vertex = lcf::graph::vertex;
+    using T = std::remove_cvref_t<decltype(std::declval<const Matrix&>()(0, 0))>;
+    static constexpr T inf = std::numeric_limits<T>::max();
+    kuhn_munkres(const Matrix& cost) {
+        if constexpr (requires { cost.dimension(); }) { solve(cost, cost.dimension(), cost.dimension()); }
+        else { solve(cost, cost.row_size(), cost.col_size()); }
+    }
+    void solve(const Matrix& cost, Vertex n, Vertex m) {
+        std::vector<T> u(n), v(m + 1), minv(m);
+        std::vector<Vertex> way(m + 1), visited;
+        std::vector<char> used(m + 1);
+        matched_with.assign(m + 1, lcf::graph::nvtx); //* column m is the virtual column the new row starts from
+        for (Vertex i = 0; i < n; ++i) {
+            matched_with[m] = i;
+            std::ranges::fill(minv, inf); std::ranges::fill(used, 0);
+            visited.clear();
+            Vertex j0 = m;
+            do {
+                used[j0] = true; visited.emplace_back(j0);
+                Vertex i0 = matched_with[j0];
+                const T* row = &cost(i0, 0);
+                T ui = u[i0], delta = inf;
+                for (Vertex j = 0; j < m; ++j) {
+                    T cur = row[j] - ui - v[j];
+                    bool better = not used[j] and cur < minv[j];
+                    minv[j] = better ? cur : minv[j];
+                    way[j] = better ? j0 : way[j];
+                }
+                for (Vertex j = 0; j < m; ++j) { delta = std::min(delta, used[j] ? inf : minv[j]); }
+                Vertex j1 = 0;
+                while (used[j1] or minv[j1] != delta) { ++j1; }
+                for (auto j : visited) { u[matched_with[j]] += delta; v[j] -= delta; }
+                for (Vertex j = 0; j < m; ++j) { minv[j] -= used[j] ? T{} : delta; }
+                j0 = j1;
+            } while (matched_with[j0] != lcf::graph::nvtx);
+            while (j0 != m) { Vertex j1 = way[j0]; matched_with[j0] = matched_with[j1]; j0 = j1; }
+        }
+        matched_with.pop_back();
+        minimum_cost = T{};
+        for (Vertex j = 0; j < m; ++j) { if (matched_with[j] != lcf::graph::nvtx) { minimum_cost += cost(matched_with[j], j); } }
+    }
+    std::vector<Vertex> matched_with;
+    T minimum_cost;
+};
+
 #endif
\ No newline at end of file
@@ -0,0 +1,129 @@
+#ifndef BIT_GRAPH_H
+#define BIT_GRAPH_H
+#include "graph.h"
+#include <bit>
+#include <cstdint>
+
+namespace lcf {
+    namespace am {
+        struct bit_edge {
+            using vertex = lcf::graph::vertex;
+            bit_edge(vertex head = lcf::graph::nvtx) : _head(head) { }
+            vertex head() const { return _head; }
+        protected:
+            vertex _head;
+        };
+
+        /*
+        * unweighted adjacency matrix with one bit per cell, every row is padded to whole 64-bit words;
+        * operator[] walks the set bits of a row, so the graph/ algorithms for unweighted graphs run on it
+        */
+        class bit_graph {
+        public:
+            using word_type = std::uint64_t;
+            using edge_type = bit_edge;
+            using vertex = lcf::graph::vertex;
+            static constexpr size_t word_bits = 64;
+            bit_graph(size_t size) : _size(size), _row_words((size + word_bits - 1) / word_bits), words(_size * _row_words) { }
+            size_t size() const { return _size; }
+            size_t dimension() const { return _size; }
+            size_t row_words() const { return _row_words; }
+            word_type* row(vertex tail) { return words.data() + tail * _row_words; }
+            const word_type* row(vertex tail) const { return words.data() + tail * _row_words; }
+            void emplace_edge(vertex tail, vertex head) { row(tail)[head / word_bits] |= word_type{1} << head % word_bits; }
+            void erase_edge(vertex tail, vertex head) { row(tail)[head / word_bits] &= ~(word_type{1} << head % word_bits); }
+            bool operator()(vertex tail, vertex head) const { return row(tail)[head / word_bits] >> head % word_bits & 1; }
+            size_t degree(vertex tail) const {
+                size_t result = 0;
+                for (auto p = row(tail), last = p + _row_words; p != last; ++p) { result += std::popcount(*p); }
+                return result;
+            }
+            struct iterator {
+                iterator(const word_type* p = nullptr, const word_type* l = nullptr, vertex b = 0)
+                : word(p), last(l), base(b), bits(p != l ? *p : 0) { skip(); }
+                bit_edge operator*() const { return bit_edge(base + std::countr_zero(bits)); }
+                void operator++() { bits &= bits - 1; skip(); }
+                bool operator!=(const iterator& rhs) const { return word != rhs.word or bits != rhs.bits; }
+                void skip() {
+                    while (not bits and word != last) {
+                        base += word_bits;
+                        if (++word != last) { bits = *word; }
+                    }
+                }
+                const word_type *word, *last;
+                vertex base;
+                word_type bits;
+            };
+            struct iterator_wrapper {
+                iterator begin() const { return _begin; }
+                iterator end() const { return _end; }
+                iterator _begin, _end;
+            };
+            iterator begin(vertex tail) const { return iterator(row(tail), row(tail) + _row_words); }
+            iterator end(vertex tail) const { return iterator(row(tail) + _row_words, row(tail) + _row_words); }
+            iterator_wrapper operator[](vertex tail) const { return iterator_wrapper{begin(tail), end(tail)}; }
+        private:
+            size_t _size, _row_words;
+            std::vector<word_type> words;
+        };
+    }
+}
+
+namespace lcf {
+    /*
+    * level synchronous bfs over words: next = (OR of the rows of frontier) AND NOT visited;
+    * returns the depth of every vertex, -1 if unreachable
+    */
+    inline std::vector<int> bfs(const am::bit_graph& graph, graph::vertex source) {
+        using Word = am::bit_graph::word_type;
+        constexpr size_t bits = am::bit_graph::word_bits;
+        size_t words = graph.row_words();
+        std::vector<int> depth(graph.size(), -1);
+        std::vector<Word> visited(words), frontier(words), next(words);
+        visited[source / bits] = frontier[source / bits] = Word{1} << source % bits;
+        depth[source] = 0;
+        for (int level = 1; ; ++level) {
+            std::fill(next.begin(), next.end(), 0);
+            for (size_t w = 0; w < words; ++w) {
+                for (auto word = frontier[w]; word; word &= word - 1) {
+                    auto row = graph.row(w * bits + std::countr_zero(word));
+                    for (size_t i = 0; i < words; ++i) { next[i] |= row[i]; }
+                }
+            }
+            bool updated = false;
+            for (size_t w = 0; w < words; ++w) {
+                next[w] &= ~visited[w];
+                visited[w] |= next[w];
+                for (auto word = next[w]; word; word &= word - 1) { depth[w * bits + std::countr_zero(word)] = level; }
+                updated |= next[w] != 0;
+            }
+            if (not updated) { break; }
+            std::swap(frontier, next);
+        }
+        return depth;
+    }
+
+    //* Warshall over rows: if i reaches k then i reaches everything k reaches; a vertex reaches itself only through a cycle
+    inline am::bit_graph transitive_closure(am::bit_graph graph) {
+        size_t n = graph.size(), words = graph.row_words();
+        for (size_t k = 0; k < n; ++k) {
+            auto row_k = graph.row(k);
+            for (size_t i = 0; i < n; ++i) {
+                if (not graph(i, k)) { continue; }
+                auto row_i = graph.row(i);
+                for (size_t w = 0; w < words; ++w) { row_i[w] |= row_k[w]; }
+            }
+        }
+        return graph;
+    }
+
+    //* number of vertices that are out neighbours of both u and v
+    inline size_t common_neighbours(const am::bit_graph& graph, graph::vertex u, graph::vertex v) {
+        size_t result = 0;
+        auto row_u = graph.row(u), row_v = graph.row(v);
+        for (size_t w = 0, words = graph.row_words(); w < words; ++w) { result += std::popcount(row_u[w] & row_v[w]); }
+        return result;
+    }
+}
+
+#endif
@@ -0,0 +1,260 @@
+#ifndef BUILDER_H
+#define BUILDER_H
+#include "graph.h"
+#include "parallel.h"
+#include <memory>
+#include <numeric>
+#include <utility>
+
+namespace lcf {
+    namespace builder {
+        template <typename Edge>
+        struct list_edge { using type = graph::unweighted_edge; };
+        template <typename Edge>
+        requires requires { typename Edge::weight_type; }
+        struct list_edge<Edge> { using type = graph::weighted_edge<typename Edge::weight_type>; };
+        template <typename Graph>
+        struct is_cfs : std::false_type { };
+        template <typename Edge, template <typename> typename Storage>
+        struct is_cfs<cfs::graph<Edge, Storage>> : std::true_type { };
+        template <typename Graph>
+        struct is_csr : std::false_type { };
+        template <typename Edge, template <typename...> typename Container>
+        struct is_csr<csr::graph<Edge, Container>> : std::true_type { };
+
+        //* [begin, end) of vertices whose out edges are about the idx-th part of all edges
+        inline std::pair<size_t, size_t>
+        balanced_vertex_range(const std::vector<size_t>& offsets, size_t thread_num, size_t idx) {
+            auto [first, last] = split_range(offsets.back(), thread_num, idx);
+            size_t begin = std::lower_bound(offsets.begin(), offsets.end() - 1, first) - offsets.begin();
+            size_t end = idx + 1 == thread_num ? offsets.size() - 1
+                : std::lower_bound(offsets.begin(), offsets.end() - 1, last) - offsets.begin();
+            return std::make_pair(begin, end);
+        }
+
+        /*
+        * sort every row by (head, value) and keep the first edge of each head;
+        * rows are compacted inside the block of each thread first, then the blocks are moved to the front
+        */
+        template <typename Storage>
+        void sort_unique_rows(std::vector<size_t>& offsets, std::vector<graph::vertex>& heads,
+            std::vector<Storage>& weights, size_t thread_num)
+        {
+            constexpr bool weighted = not std::is_same_v<Storage, std::nullptr_t>;
+            std::vector<std::pair<size_t, size_t>> ranges(thread_num);
+            std::vector<size_t> block_begin(thread_num + 1), kept(thread_num + 1);
+            for (size_t idx = 0; idx < thread_num; ++idx) {
+                ranges[idx] = balanced_vertex_range(offsets, thread_num, idx);
+                block_begin[idx] = offsets[ranges[idx].first];
+            }
+            block_begin[thread_num] = offsets.back();
+            parallel_for(thread_num, [&](size_t idx) {
+                auto [begin, end] = ranges[idx];
+                std::vector<std::pair<graph::vertex, Storage>> buffer;
+                size_t write = block_begin[idx];
+                for (size_t u = begin; u < end; ++u) {
+                    size_t row_begin = offsets[u], row_end = u + 1 == end ? block_begin[idx + 1] : offsets[u + 1];
+                    offsets[u] = write;
+                    if constexpr (weighted) {
+                        buffer.clear();
+                        for (size_t i = row_begin; i < row_end; ++i) { buffer.emplace_back(heads[i], weights[i]); }
+                        std::sort(buffer.begin(), buffer.end());
+                        for (size_t i = 0, k = buffer.size(); i < k; ++i) {
+                            if (i and buffer[i].first == buffer[i - 1].first) { continue; }
+                            heads[write] = buffer[i].first; weights[write] = std::move(buffer[i].second); ++write;
+                        }
+                    } else {
+                        std::sort(heads.begin() + row_begin, heads.begin() + row_end);
+                        auto last = std::unique(heads.begin() + row_begin, heads.begin() + row_end);
+                        write = std::move(heads.begin() + row_begin, last, heads.begin() + write) - heads.begin();
+                    }
+                }
+                kept[idx + 1] = write - block_begin[idx];
+            });
+            std::partial_sum(kept.begin(), kept.end(), kept.begin());
+            for (size_t idx = 1; idx < thread_num; ++idx) { //* moving left in order never overwrites an unmoved block
+                auto first = block_begin[idx], last = first + kept[idx + 1] - kept[idx];
+                std::move(heads.begin() + first, heads.begin() + last, heads.begin() + kept[idx]);
+                if constexpr (weighted) { std::move(weights.begin() + first, weights.begin() + last, weights.begin() + kept[idx]); }
+            }
+            parallel_for(thread_num, [&](size_t idx) {
+                auto [begin, end] = ranges[idx];
+                for (size_t u = begin; u < end; ++u) { offsets[u] -= block_begin[idx] - kept[idx]; }
+            });
+            offsets.back() = kept[thread_num];
+            heads.resize(kept[thread_num]);
+            if constexpr (weighted) { weights.resize(kept[thread_num]); }
+        }
+
+        //* [begin, end) of the edges of the idx-th thread, chunks start at even edges so that paired edges stay in one chunk
+        inline std::pair<size_t, size_t> edge_range(size_t edge_num, size_t thread_num, size_t idx) {
+            auto [begin, end] = split_range(edge_num, thread_num, idx);
+            return std::make_pair(begin & ~size_t{1}, idx + 1 == thread_num ? edge_num : end & ~size_t{1});
+        }
+
+        /*
+        * write positions of the counting sort: thread t counts the degrees of its own chunk only over the tails
+        * [low[t], high[t]) found in it, so an edge list grouped by tail needs about vertex_num counters in all;
+        * when the ranges add up to more than max(edge_num, vertex_num), thread_num drops to edge_num / vertex_num
+        * and every thread counts over all vertices, so the counters never outgrow the edge list
+        */
+        struct scatter_plan {
+            size_t thread_num;
+            std::vector<size_t> low, high, base;
+            std::unique_ptr<size_t[]> count;
+            //* where thread idx writes its next edge of u
+            size_t& position(size_t idx, size_t u) { return count[base[idx] + u - low[idx]]; }
+            bool counts(size_t idx, size_t u) const { return low[idx] <= u and u < high[idx]; }
+        };
+
+        //* a prefix sum of the counts gives the row offsets and turns every count into a write position
+        template <typename ListEdge>
+        scatter_plan scatter_positions(size_t vertex_num, const std::vector<ListEdge>& edges,
+            size_t thread_num, std::vector<size_t>& offsets)
+        {
+            size_t n = vertex_num, m = edges.size();
+            scatter_plan plan{thread_num, std::vector<size_t>(thread_num, n), std::vector<size_t>(thread_num, 0),
+                std::vector<size_t>(thread_num + 1, 0), nullptr};
+            parallel_for(thread_num, [&](size_t idx) {
+                auto [begin, end] = edge_range(m, thread_num, idx);
+                size_t low = n, high = 0;
+                for (size_t k = begin; k < end; ++k) {
+                    low = std::min<size_t>(low, edges[k]._u); high = std::max<size_t>(high, edges[k]._u + 1);
+                }
+                plan.low[idx] = std::min(low, high); plan.high[idx] = high;
+            });
+            for (size_t idx = 0; idx < thread_num; ++idx) { plan.base[idx + 1] = plan.base[idx] + plan.high[idx] - plan.low[idx]; }
+            if (plan.base[thread_num] > std::max(m, n)) {
+                plan.thread_num = thread_num = std::clamp<size_t>(m / n, 1, thread_num);
+                plan.low.assign(thread_num, 0); plan.high.assign(thread_num, n); plan.base.resize(thread_num + 1);
+                for (size_t idx = 0; idx <= thread_num; ++idx) { plan.base[idx] = idx * n; }
+            }
+            plan.count = std::make_unique_for_overwrite<size_t[]>(plan.base[thread_num]);
+            parallel_for(thread_num, [&](size_t idx) {
+                std::fill(plan.count.get() + plan.base[idx], plan.count.get() + plan.base[idx + 1], 0);
+                auto [begin, end] = edge_range(m, thread_num, idx);
+                for (size_t k = begin; k < end; ++k) { ++plan.position(idx, edges[k]._u); }
+            });
+            offsets.assign(n + 1, 0);
+            std::vector<size_t> block(thread_num + 1);
+            parallel_for(thread_num, [&](size_t idx) {
+                auto [begin, end] = split_range(n, thread_num, idx);
+                for (size_t u = begin; u < end; ++u) {
+                    size_t degree = 0;
+                    for (size_t t = 0; t < thread_num; ++t) { //* count becomes the position inside the row
+                        if (plan.counts(t, u)) { auto& count = plan.position(t, u); degree += std::exchange(count, degree); }
+                    }
+                    offsets[u] = degree; block[idx + 1] += degree;
+                }
+            });
+            std::partial_sum(block.begin(), block.end(), block.begin());
+            parallel_for(thread_num, [&](size_t idx) {
+                auto [begin, end] = split_range(n, thread_num, idx);
+                for (size_t u = begin, offset = block[idx]; u < end; ++u) {
+                    auto degree = std::exchange(offsets[u], offset);
+                    for (size_t t = 0; t < thread_num; ++t) { if (plan.counts(t, u)) { plan.position(t, u) += offset; } }
+                    offset += degree;
+                }
+            });
+            offsets[n] = m;
+            return plan;
+        }
+
+        /*
+        * counting sort of an edge list into csr::graph: scatter_positions, then every thread of the plan scatters its chunk;
+        * rows keep the order of the edge list and edge k is paired with k ^ 1 as in cfs::graph
+        */
+        template <typename Edge, typename ListEdge>
+        csr::graph<Edge> build_csr(size_t vertex_num, const std::vector<ListEdge>& edges,
+            bool sort_unique, size_t thread_num)
+        {
+            using Storage = typename csr::graph<Edge>::storage_type;
+            constexpr bool weighted = csr::graph<Edge>::weighted;
+            size_t m = edges.size();
+            std::vector<size_t> offsets;
+            auto plan = scatter_positions(vertex_num, edges, thread_num, offsets);
+            thread_num = plan.thread_num;
+            std::vector<graph::vertex> heads(m);
+            std::vector<Storage> weights(weighted ? m : 0);
+            std::vector<size_t> reverse(sort_unique ? 0 : m);
+            parallel_for(thread_num, [&](size_t idx) {
+                auto [begin, end] = edge_range(m, thread_num, idx);
+                for (size_t k = begin, pre = 0; k < end; ++k) {
+                    auto pos = plan.position(idx, edges[k]._u)++;
+                    heads[pos] = edges[k]._v;
+                    if constexpr (weighted and ListEdge::has_value::value) { weights[pos] = edges[k]._w; }
+                    if (sort_unique) { continue; }
+                    if (k & 1) { reverse[pos] = pre; reverse[pre] = pos; }
+                    else { reverse[pos] = pre = pos; } //* the last edge of an odd edge list pairs with itself
+                }
+            });
+            plan.count.reset();
+            if (sort_unique) { sort_unique_rows(offsets, heads, weights, thread_num); }
+            return csr::graph<Edge>(std::move(offsets), std::move(heads), std::move(weights), std::move(reverse));
+        }
+
+        /*
+        * the same counting sort straight into the rows of al::graph: every row is allocated once at its counted degree
+        * and filled with placeholder edges (al edges have no default constructor), then every thread scatters its chunk;
+        * sort_unique sorts every row by (head, value) and keeps the first edge of each head in place
+        */
+        template <typename Graph, typename ListEdge>
+        Graph build_al(size_t vertex_num, const std::vector<ListEdge>& edges, bool sort_unique, size_t thread_num) {
+            using Edge = typename Graph::edge_type;
+            constexpr bool weighted = requires { typename Edge::weight_type; };
+            size_t m = edges.size();
+            std::vector<size_t> offsets;
+            auto plan = scatter_positions(vertex_num, edges, thread_num, offsets);
+            thread_num = plan.thread_num;
+            Graph result(vertex_num);
+            parallel_for(thread_num, [&](size_t idx) {
+                auto [begin, end] = balanced_vertex_range(offsets, thread_num, idx);
+                for (graph::vertex u = begin; u < static_cast<graph::vertex>(end); ++u)
+                { result[u].assign(offsets[u + 1] - offsets[u], Edge(graph::nvtx)); }
+            });
+            parallel_for(thread_num, [&](size_t idx) {
+                auto [begin, end] = edge_range(m, thread_num, idx);
+                for (size_t k = begin; k < end; ++k) {
+                    auto u = edges[k]._u;
+                    auto& edge = result[u][plan.position(idx, u)++ - offsets[u]];
+                    if constexpr (weighted and ListEdge::has_value::value) { edge = Edge(edges[k]._v, edges[k]._w); }
+                    else { edge = Edge(edges[k]._v); }
+                }
+            });
+            plan.count.reset();
+            if (not sort_unique) { return result; }
+            parallel_for(thread_num, [&](size_t idx) {
+                auto [begin, end] = balanced_vertex_range(offsets, thread_num, idx);
+                for (graph::vertex u = begin; u < static_cast<graph::vertex>(end); ++u) {
+                    auto& row = result[u];
+                    if constexpr (weighted) {
+                        std::sort(row.begin(), row.end(), [](const Edge& lhs, const Edge& rhs)
+                        { return std::make_pair(lhs.head(), lhs.value()) < std::make_pair(rhs.head(), rhs.value()); });
+                    } else { std::sort(row.begin(), row.end(), [](const Edge& lhs, const Edge& rhs) { return lhs.head() < rhs.head(); }); }
+                    row.erase(std::unique(row.begin(), row.end(), [](const Edge& lhs, const Edge& rhs)
+                        { return lhs.head() == rhs.head(); }), row.end());
+                }
+            });
+            return result;
+        }
+    }
+
+    /*
+    * build csr::graph or al::graph from an edge list of lcf::graph::weighted_edge or lcf::graph::unweighted_edge;
+    * storage of csr::graph and every row of al::graph is allocated once, besides the counters of scatter_positions
+    * that never exceed max(edge_num, vertex_num);
+    * sort_unique sorts every row by (head, value) and keeps the first edge of each head,
+    * after which csr::graph no longer pairs edges for operator~
+    */
+    template <typename Graph, typename ListEdge>
+    Graph parallel_build(size_t vertex_num, const std::vector<ListEdge>& edges,
+        bool sort_unique = false, size_t thread_num = default_thread_num())
+    {
+        thread_num = std::clamp<size_t>(thread_num, 1, std::max<size_t>(1, edges.size() / 2));
+        if constexpr (builder::is_csr<Graph>::value)
+        { return builder::build_csr<typename Graph::edge_type>(vertex_num, edges, sort_unique, thread_num); }
+        else { return builder::build_al<Graph>(vertex_num, edges, sort_unique, thread_num); }
+    }
+}
+
+#endif
@@ -0,0 +1,155 @@
+#ifndef CONTRACTION_HIERARCHY_H
+#define CONTRACTION_HIERARCHY_H
+#include "graph.h"
+#include "shortest_path.h"
+
+namespace lcf {
+    /*
+    * contraction hierarchy of a directed graph with non-negative weights:
+    * vertices are contracted in increasing importance = 4 * edge difference + contracted neighbours + level,
+    * where the level of a vertex is one more than the highest level of its contracted neighbours;
+    * importance is recomputed when a vertex is popped and the vertex is pushed back if it is no longer the smallest;
+    * contracting v adds u -> w for every pair u -> v -> w with no witness path avoiding v found
+    * by a dijkstra from u that settles at most witness_limit vertices;
+    * vertices are relabeled by contraction rank, upward keeps the edges to higher ranks
+    * and downward the reversed edges from higher ranks, so a query is two upward dijkstras
+    */
+    template <typename Weight>
+    class contraction_hierarchy {
+    public:
+        using vertex = graph::vertex;
+        using edge_type = csr::weighted_edge<Weight>;
+        using graph_type = csr::graph<edge_type>;
+        using workspace_type = sssp_workspace<Weight>;
+        static constexpr Weight inf = edge_type::inf; //* of the searches inside the hierarchy
+        template <typename Graph>
+        contraction_hierarchy(const Graph& graph, size_t witness_limit = 500)
+        : rank(graph.size()), unreachable(Graph::edge_type::inf) { build(graph, witness_limit); }
+        size_t size() const { return rank.size(); }
+        size_t shortcut_size() const { return shortcut_num; }
+        //* source to target distance, the inf of the input graph's edge type if unreachable as with dijkstra on it
+        Weight distance(vertex source, vertex target, workspace_type& forward, workspace_type& backward) const {
+            forward.start(size(), inf); backward.start(size(), inf);
+            source = rank[source]; target = rank[target];
+            forward.set_distance(source, Weight{}); forward.heap.push(std::make_pair(Weight{}, source));
+            backward.set_distance(target, Weight{}); backward.heap.push(std::make_pair(Weight{}, target));
+            Weight best = inf;
+            while (true) { //* a side stops once its heap top can no longer improve best
+                bool forward_open = not forward.heap.empty() and forward.heap.top().first < best;
+                bool backward_open = not backward.heap.empty() and backward.heap.top().first < best;
+                if (not forward_open and not backward_open) { break; }
+                bool is_forward = forward_open and (not backward_open or forward.heap.top().first <= backward.heap.top().first);
+                auto& self = is_forward ? forward : backward;
+                auto& other = is_forward ? backward : forward;
+                auto [distance, vtx] = self.heap.top(); self.heap.pop();
+                if (self.marked(vtx)) { continue; }
+                else { self.mark(vtx); }
+                if (other.touched(vtx)) { best = std::min(best, distance + other.distance(vtx)); }
+                for (const auto& edge : (is_forward ? upward : downward)[vtx]) {
+                    vertex child = edge.head();
+                    Weight new_distance = distance + edge.value();
+                    if (self.distance(child) <= new_distance) { continue; }
+                    self.set_distance(child, new_distance);
+                    self.heap.push(std::make_pair(new_distance, child));
+                }
+            }
+            return best < inf ? best : unreachable;
+        }
+        std::vector<vertex> rank;
+        graph_type upward, downward;
+    private:
+        using dynamic_graph = dyn::graph<dyn::weighted_edge<Weight>>;
+        using list_edge = graph::weighted_edge<Weight>;
+        template <typename Graph>
+        void build(const Graph& graph, size_t witness_limit) {
+            vertex n = graph.size();
+            dynamic_graph out(n, n), in(n, n);
+            auto emplace_or_improve = [&](vertex tail, vertex head, Weight weight) {
+                for (auto& edge : out[tail]) {
+                    if (edge.head() != head) { continue; }
+                    if (weight < edge.value()) {
+                        edge.value() = weight;
+                        for (auto& rev_edge : in[head]) { if (rev_edge.head() == tail) { rev_edge.value() = weight; break; } }
+                    }
+                    return false;
+                }
+                out.emplace_edge(tail, head, weight); in.emplace_edge(head, tail, weight);
+                return true;
+            };
+            for (vertex u = 0; u < n; ++u) {
+                for (const auto& edge : graph[u]) { if (edge.head() != u) { emplace_or_improve(u, edge.head(), edge.value()); } }
+            }
+            workspace_type workspace(n);
+            std::vector<list_edge> shortcuts, up_edges, down_edges;
+            std::vector<char> is_target(n);
+            //* witness searches of v, shortcuts of v are left in shortcuts
+            auto contract = [&](vertex v) {
+                shortcuts.clear();
+                Weight max_out{};
+                for (const auto& edge : out[v]) { max_out = std::max(max_out, edge.value()); is_target[edge.head()] = true; }
+                for (const auto& in_edge : in[v]) {
+                    vertex u = in_edge.head();
+                    Weight limit = in_edge.value() + max_out;
+                    workspace.start(n, inf);
+                    workspace.set_distance(u, Weight{}); workspace.heap.push(std::make_pair(Weight{}, u));
+                    size_t targets = out.degree(v); //* the search stops once every out neighbour of v is settled
+                    for (size_t settled = 0; not workspace.heap.empty() and settled < witness_limit; ++settled) {
+                        auto [distance, vtx] = workspace.heap.top(); workspace.heap.pop();
+                        if (distance > limit or (is_target[vtx] and not --targets)) { break; }
+                        for (const auto& edge : out[vtx]) {
+                            vertex child = edge.head();
+                            Weight new_distance = distance + edge.value();
+                            if (child == v or workspace.distance(child) <= new_distance) { continue; }
+                            workspace.set_distance(child, new_distance);
+                            workspace.heap.push(std::make_pair(new_distance, child));
+                        }
+                    }
+                    for (const auto& out_edge : out[v]) {
+                        vertex w = out_edge.head();
+                        Weight via = in_edge.value() + out_edge.value();
+                        if (w != u and via < workspace.distance(w)) { shortcuts.emplace_back(u, w, via); }
+                    }
+                }
+                for (const auto& edge : out[v]) { is_target[edge.head()] = false; }
+            };
+            std::vector<int> contracted_neighbours(n), level(n);
+            auto importance = [&](vertex v) {
+                contract(v);
+                int edge_difference = static_cast<int>(shortcuts.size()) - static_cast<int>(out.degree(v) + in.degree(v));
+                return 4 * edge_difference + contracted_neighbours[v] + level[v];
+            };
+            using Pair = std::pair<int, vertex>;
+            lcf::indexed_4ary_heap<Pair, std::greater<Pair>> queue; queue.reserve(n);
+            for (vertex v = 0; v < n; ++v) { queue.push(std::make_pair(importance(v), v)); }
+            shortcut_num = 0;
+            for (vertex order = 0; not queue.empty();) {
+                vertex v = queue.top().second; queue.pop();
+                int current = importance(v);
+                if (not queue.empty() and current > queue.top().first) { queue.push(std::make_pair(current, v)); continue; }
+                rank[v] = order++;
+                auto detach = [&](vertex neighbour) {
+                    ++contracted_neighbours[neighbour];
+                    level[neighbour] = std::max(level[neighbour], level[v] + 1);
+                };
+                for (const auto& edge : out[v]) {
+                    up_edges.emplace_back(v, edge.head(), edge.value());
+                    in.erase_edge(edge.head(), v); detach(edge.head());
+                }
+                for (const auto& edge : in[v]) {
+                    down_edges.emplace_back(v, edge.head(), edge.value());
+                    out.erase_edge(edge.head(), v); detach(edge.head());
+                }
+                for (const auto& shortcut : shortcuts) { shortcut_num += emplace_or_improve(shortcut._u, shortcut._v, shortcut._w); }
+                while (out.degree(v)) { out.erase_edge_at(v, out.degree(v) - 1); }
+                while (in.degree(v)) { in.erase_edge_at(v, in.degree(v) - 1); }
+            }
+            for (auto& edge : up_edges) { edge._u = rank[edge._u]; edge._v = rank[edge._v]; }
+            for (auto& edge : down_edges) { edge._u = rank[edge._u]; edge._v = rank[edge._v]; }
+            upward = graph_type(n, up_edges); downward = graph_type(n, down_edges);
+        }
+        size_t shortcut_num;
+        Weight unreachable;
+    };
+}
+
+#endif
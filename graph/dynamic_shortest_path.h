@@ -0,0 +1,122 @@
+#ifndef DYNAMIC_SHORTEST_PATH_H
+#define DYNAMIC_SHORTEST_PATH_H
+#include "graph.h"
+#include "heap.h"
+#include <tr2/dynamic_bitset>
+
+namespace lcf {
+    /*
+    * single source shortest paths kept up to date under edge weight changes, weights must be non-negative;
+    * the graph is copied into dyn::graph out and in lists, parallel edges are merged keeping the lightest;
+    * a decrease runs dijkstra from the head of the edge through the vertices it improves,
+    * an increase of a tree edge u -> v resets the subtree of v, seeds every vertex of it from its in edges
+    * out of the subtree and runs dijkstra inside the subtree (Ramalingam-Reps), other increases change nothing;
+    * inf marks absent edges, an unreachable vertex has the inf of the input graph's edge type as with dijkstra on it
+    */
+    template <typename Weight>
+    class dynamic_sssp {
+    public:
+        using vertex = graph::vertex;
+        using edge_type = dyn::weighted_edge<Weight>;
+        static constexpr Weight inf = edge_type::inf;
+        template <typename Graph>
+        dynamic_sssp(const Graph& graph, vertex s)
+        : out(graph.size()), in(graph.size()), source(s), unreachable(Graph::edge_type::inf),
+          shortest(graph.size(), unreachable), parents(graph.size(), graph::nvtx), affected(graph.size())
+        {
+            for (vertex u = 0, n = graph.size(); u < n; ++u) {
+                for (const auto& edge : graph[u]) { emplace_or_decrease(u, edge.head(), edge.value()); }
+            }
+            shortest[source] = Weight{};
+            heap.push(std::make_pair(Weight{}, source));
+            propagate(false);
+        }
+        size_t size() const { return shortest.size(); }
+        Weight distance(vertex vtx) const { return shortest[vtx]; }
+        //* previous vertex on the shortest path, nvtx for source and unreachable vertices
+        vertex parent(vertex vtx) const { return parents[vtx]; }
+        const std::vector<Weight>& distances() const { return shortest; }
+        Weight weight(vertex tail, vertex head) const {
+            for (const auto& edge : out[tail]) { if (edge.head() == head) { return edge.value(); } }
+            return inf;
+        }
+        //* set the weight of tail -> head, the edge is added if absent and erased if weight is inf
+        void update_edge(vertex tail, vertex head, Weight weight) {
+            Weight old_weight = this->weight(tail, head);
+            if (weight == old_weight) { return; }
+            set_weight(tail, head, weight);
+            if (weight < old_weight) { decrease(tail, head, weight); }
+            else if (parents[head] == tail) { increase(head); }
+        }
+        void erase_edge(vertex tail, vertex head) { update_edge(tail, head, inf); }
+    private:
+        void emplace_or_decrease(vertex tail, vertex head, Weight weight) {
+            if (weight < this->weight(tail, head)) { set_weight(tail, head, weight); }
+        }
+        void set_weight(vertex tail, vertex head, Weight weight) {
+            auto assign = [weight](dyn::graph<edge_type>& g, vertex u, vertex v) {
+                auto row = g[u];
+                for (size_t idx = 0; idx < row.size(); ++idx) {
+                    if (row[idx].head() != v) { continue; }
+                    if (weight == inf) { g.erase_edge_at(u, idx); }
+                    else { row[idx].value() = weight; }
+                    return;
+                }
+                if (weight != inf) { g.emplace_edge(u, v, weight); }
+            };
+            assign(out, tail, head); assign(in, head, tail);
+        }
+        void decrease(vertex tail, vertex head, Weight weight) {
+            if (shortest[tail] == unreachable or shortest[tail] + weight >= shortest[head]) { return; }
+            shortest[head] = shortest[tail] + weight; parents[head] = tail;
+            heap.push(std::make_pair(shortest[head], head));
+            propagate(false);
+        }
+        void increase(vertex root) {
+            subtree.clear(); subtree.emplace_back(root); affected[root] = true;
+            for (size_t front = 0; front < subtree.size(); ++front) { //* children are the heads whose parent is the tail
+                vertex vtx = subtree[front];
+                for (const auto& edge : out[vtx]) {
+                    vertex child = edge.head();
+                    if (parents[child] != vtx or affected[child]) { continue; }
+                    affected[child] = true; subtree.emplace_back(child);
+                }
+            }
+            for (auto vtx : subtree) { shortest[vtx] = unreachable; parents[vtx] = graph::nvtx; }
+            for (auto vtx : subtree) {
+                for (const auto& edge : in[vtx]) {
+                    vertex tail = edge.head();
+                    if (affected[tail] or shortest[tail] == unreachable or shortest[tail] + edge.value() >= shortest[vtx]) { continue; }
+                    shortest[vtx] = shortest[tail] + edge.value(); parents[vtx] = tail;
+                }
+                if (shortest[vtx] != unreachable) { heap.push(std::make_pair(shortest[vtx], vtx)); }
+            }
+            propagate(true);
+            for (auto vtx : subtree) { affected[vtx] = false; }
+        }
+        //* dijkstra from the vertices in heap, only into affected vertices if inside_affected
+        void propagate(bool inside_affected) {
+            while (not heap.empty()) {
+                auto [distance, vtx] = heap.top(); heap.pop();
+                if (distance != shortest[vtx]) { continue; }
+                for (const auto& edge : out[vtx]) {
+                    vertex child = edge.head();
+                    if (inside_affected and not affected[child]) { continue; }
+                    Weight new_distance = distance + edge.value();
+                    if (new_distance >= shortest[child]) { continue; }
+                    shortest[child] = new_distance; parents[child] = vtx;
+                    heap.push(std::make_pair(new_distance, child));
+                }
+            }
+        }
+        dyn::graph<edge_type> out, in;
+        vertex source;
+        Weight unreachable;
+        std::vector<Weight> shortest;
+        std::vector<vertex> parents, subtree;
+        std::tr2::dynamic_bitset<> affected;
+        lcf::indexed_4ary_heap<std::pair<Weight, vertex>, std::greater<std::pair<Weight, vertex>>> heap;
+    };
+}
+
+#endif
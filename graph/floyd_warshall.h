@@ -0,0 +1,178 @@
+#ifndef FLOYD_WARSHALL_H
+#define FLOYD_WARSHALL_H
+#include "graph.h"
+#include "parallel.h"
+#include <atomic>
+#include <barrier>
+#if defined(__x86_64__) or defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace lcf {
+    namespace min_plus {
+        /*
+        * c[j] = min(c[j], a[k] + b[k * stride + j]) for k in [0, depth) and j in [0, cols),
+        * c is one row of a tile, a the same row of the tile in the pivot columns, b the pivot rows;
+        * c must not overlap a or b
+        */
+        template <typename T>
+        void rows(T* c, const T* a, const T* b, size_t stride, size_t depth, size_t cols) {
+            for (size_t k = 0; k < depth; ++k) {
+                T a_k = a[k];
+                const T* b_k = b + k * stride;
+                for (size_t j = 0; j < cols; ++j) { c[j] = std::min<T>(c[j], a_k + b_k[j]); }
+            }
+        }
+
+#if defined(__x86_64__) or defined(__i386__)
+        inline bool has_avx2() {
+            static const bool result = __builtin_cpu_supports("avx2");
+            return result;
+        }
+
+        /*
+        * AVX2 versions of rows(): four vectors of c stay in registers while all depth pivot rows are applied;
+        * Vec provides load, store, broadcast, add and min for one element type, the integer ones take T itself
+        * so that the matrix is only accessed as T
+        */
+        template <typename T, typename Vec>
+        __attribute__((target("avx2"))) inline
+        void rows_avx2(T* c, const T* a, const T* b, size_t stride, size_t depth, size_t cols) {
+            constexpr size_t lanes = 32 / sizeof(T), step = lanes * 4;
+            size_t j = 0;
+            for (; j + step <= cols; j += step) {
+                auto c0 = Vec::load(c + j), c1 = Vec::load(c + j + lanes);
+                auto c2 = Vec::load(c + j + 2 * lanes), c3 = Vec::load(c + j + 3 * lanes);
+                for (size_t k = 0; k < depth; ++k) {
+                    auto a_k = Vec::broadcast(a[k]);
+                    const T* b_k = b + k * stride + j;
+                    c0 = Vec::min(c0, Vec::add(a_k, Vec::load(b_k)));
+                    c1 = Vec::min(c1, Vec::add(a_k, Vec::load(b_k + lanes)));
+                    c2 = Vec::min(c2, Vec::add(a_k, Vec::load(b_k + 2 * lanes)));
+                    c3 = Vec::min(c3, Vec::add(a_k, Vec::load(b_k + 3 * lanes)));
+                }
+                Vec::store(c + j, c0); Vec::store(c + j + lanes, c1);
+                Vec::store(c + j + 2 * lanes, c2); Vec::store(c + j + 3 * lanes, c3);
+            }
+            if (j < cols) { rows(c + j, a, b + j, stride, depth, cols - j); }
+        }
+        template <typename T>
+        struct vec_i32 {
+            using type = __m256i;
+            __attribute__((target("avx2"))) static type load(const T* p) { return _mm256_loadu_si256(reinterpret_cast<const type*>(p)); }
+            __attribute__((target("avx2"))) static void store(T* p, type v) { _mm256_storeu_si256(reinterpret_cast<type*>(p), v); }
+            __attribute__((target("avx2"))) static type broadcast(T x) { return _mm256_set1_epi32(x); }
+            __attribute__((target("avx2"))) static type add(type x, type y) { return _mm256_add_epi32(x, y); }
+            __attribute__((target("avx2"))) static type min(type x, type y) { return _mm256_min_epi32(x, y); }
+        };
+        template <typename T>
+        struct vec_i64 {
+            using type = __m256i;
+            __attribute__((target("avx2"))) static type load(const T* p) { return _mm256_loadu_si256(reinterpret_cast<const type*>(p)); }
+            __attribute__((target("avx2"))) static void store(T* p, type v) { _mm256_storeu_si256(reinterpret_cast<type*>(p), v); }
+            __attribute__((target("avx2"))) static type broadcast(T x) { return _mm256_set1_epi64x(x); }
+            __attribute__((target("avx2"))) static type add(type x, type y) { return _mm256_add_epi64(x, y); }
+            __attribute__((target("avx2"))) static type min(type x, type y) { return _mm256_blendv_epi8(x, y, _mm256_cmpgt_epi64(x, y)); }
+        };
+        struct vec_f32 {
+            using type = __m256;
+            __attribute__((target("avx2"))) static type load(const float* p) { return _mm256_loadu_ps(p); }
+            __attribute__((target("avx2"))) static void store(float* p, type v) { _mm256_storeu_ps(p, v); }
+            __attribute__((target("avx2"))) static type broadcast(float x) { return _mm256_set1_ps(x); }
+            __attribute__((target("avx2"))) static type add(type x, type y) { return _mm256_add_ps(x, y); }
+            __attribute__((target("avx2"))) static type min(type x, type y) { return _mm256_min_ps(x, y); }
+        };
+        struct vec_f64 {
+            using type = __m256d;
+            __attribute__((target("avx2"))) static type load(const double* p) { return _mm256_loadu_pd(p); }
+            __attribute__((target("avx2"))) static void store(double* p, type v) { _mm256_storeu_pd(p, v); }
+            __attribute__((target("avx2"))) static type broadcast(double x) { return _mm256_set1_pd(x); }
+            __attribute__((target("avx2"))) static type add(type x, type y) { return _mm256_add_pd(x, y); }
+            __attribute__((target("avx2"))) static type min(type x, type y) { return _mm256_min_pd(x, y); }
+        };
+        template <typename T>
+        struct vec_of { using type = void; };
+        template <typename T> requires (std::is_integral_v<T> and std::is_signed_v<T> and sizeof(T) == 4)
+        struct vec_of<T> { using type = vec_i32<T>; };
+        template <typename T> requires (std::is_integral_v<T> and std::is_signed_v<T> and sizeof(T) == 8)
+        struct vec_of<T> { using type = vec_i64<T>; };
+        template <> struct vec_of<float> { using type = vec_f32; };
+        template <> struct vec_of<double> { using type = vec_f64; };
+#endif
+
+        //* rows() on AVX2 when the cpu supports it and T is a signed 32/64-bit integer, float or double
+        template <typename T>
+        void rows_dispatch(T* c, const T* a, const T* b, size_t stride, size_t depth, size_t cols) {
+#if defined(__x86_64__) or defined(__i386__)
+            using Vec = typename vec_of<T>::type;
+            if constexpr (not std::is_void_v<Vec>) {
+                if (has_avx2()) { return rows_avx2<T, Vec>(c, a, b, stride, depth, cols); }
+            }
+#endif
+            rows(c, a, b, stride, depth, cols);
+        }
+    }
+
+    /*
+    * in place all pairs shortest paths on a distance matrix: graph(i, j) is the weight of i -> j,
+    * inf for no edge and 0 on the diagonal, inf + inf must not overflow (e.g. max >> 2 as the graph/ edges);
+    * blocked into block x block tiles: for every pivot block the diagonal tile, then the tiles in its row and column,
+    * then every other tile from the finished row and column tiles, the last phase split by tile rows over thread_num threads;
+    * the threads are started once and meet at a barrier whose completion runs the first two phases of the next pivot block;
+    * a negative circle leaves a negative value on the diagonal
+    */
+    template <typename T>
+    void floyd_warshall(am::graph<T>& graph, size_t thread_num = 1, size_t block = 64) {
+        size_t n = graph.dimension();
+        if (n == 0) { return; }
+        T* d = &graph(0, 0);
+        thread_num = std::max<size_t>(thread_num, 1);
+        //* pivots in the outer loop, so the tile may share rows or columns with the pivots
+        auto pivot_outer = [&](size_t k0, size_t k1, size_t i0, size_t i1, size_t j0, size_t j1) {
+            for (size_t k = k0; k < k1; ++k) {
+                const T* d_k = d + k * n;
+                for (size_t i = i0; i < i1; ++i) {
+                    if (i == k) { continue; } //* row k does not change with pivot k
+                    T d_ik = d[i * n + k];
+                    min_plus::rows_dispatch(d + i * n + j0, &d_ik, d_k + j0, n, 1, j1 - j0);
+                }
+            }
+        };
+        size_t block_num = (n + block - 1) / block, kb = block_num, k0 = 0, k1 = 0;
+        std::atomic<size_t> next(0);
+        //* moves to the next pivot block (the first one on the first call) and finishes its diagonal, row and column tiles
+        auto advance = [&]() noexcept {
+            kb = kb == block_num ? 0 : kb + 1;
+            if (kb == block_num) { return; }
+            k0 = kb * block; k1 = std::min(n, k0 + block);
+            pivot_outer(k0, k1, k0, k1, k0, k1);
+            for (size_t b = 0; b < block_num; ++b) {
+                if (b == kb) { continue; }
+                size_t b0 = b * block, b1 = std::min(n, b0 + block);
+                pivot_outer(k0, k1, k0, k1, b0, b1);
+                pivot_outer(k0, k1, b0, b1, k0, k1);
+            }
+            next.store(0, std::memory_order_relaxed);
+        };
+        thread_num = std::min(thread_num, block_num);
+        std::barrier sync(thread_num, advance);
+        parallel_for(thread_num, [&](size_t) {
+            while (true) {
+                sync.arrive_and_wait();
+                if (kb == block_num) { break; }
+                for (size_t ib; (ib = next.fetch_add(1, std::memory_order_relaxed)) < block_num;) {
+                    if (ib == kb) { continue; }
+                    size_t i0 = ib * block, i1 = std::min(n, i0 + block);
+                    for (size_t jb = 0; jb < block_num; ++jb) {
+                        if (jb == kb) { continue; }
+                        size_t j0 = jb * block, j1 = std::min(n, j0 + block);
+                        for (size_t i = i0; i < i1; ++i)
+                        { min_plus::rows_dispatch(d + i * n + j0, d + i * n + k0, d + k0 * n + j0, n, k1 - k0, j1 - j0); }
+                    }
+                }
+            }
+        });
+    }
+}
+
+#endif
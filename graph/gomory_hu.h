@@ -0,0 +1,104 @@
+#ifndef GOMORY_HU_H
+#define GOMORY_HU_H
+#include "graph.h"
+#include "maximum_flow.h"
+#include "parallel.h"
+#include "../matrix.h"
+#include <atomic>
+#include <memory>
+
+namespace lcf {
+    /*
+    * Gomory-Hu tree of an undirected graph given as cfs::graph with every edge stored as a pair
+    * u -> v and v -> u of the same capacity; built by Gusfield's n - 1 maximum flows from vertex i to parent[i],
+    * the vertices after i with the same parent that fall on the side of i are moved under i;
+    * every thread keeps one residual graph and resets its capacities before each flow;
+    * with several threads the flow of i starts on the parent it reads at that time and
+    * is computed again once all earlier vertices are done if that parent has changed since;
+    * the minimum cut between u and v is the lightest edge on the tree path between them
+    */
+    template <typename Graph>
+    struct gomory_hu_tree {
+        using Vertex = typename Graph::vertex;
+        using Edge = typename Graph::edge_type;
+        using Weight = typename Edge::weight_type;
+        gomory_hu_tree(Graph&& g, size_t thread_num = 1)
+        : parent(g.size(), 0), weight(g.size(), Edge::inf), depth(g.size()) { build(std::move(g), thread_num); }
+        size_t size() const { return parent.size(); }
+        //* minimum cut value between u and v, inf if u == v
+        Weight minimum_cut(Vertex u, Vertex v) const {
+            Weight result = Edge::inf;
+            while (u != v) {
+                if (depth[u] < depth[v]) { std::swap(u, v); }
+                result = std::min(result, weight[u]); u = parent[u];
+            }
+            return result;
+        }
+        //* minimum cut values of all pairs by a walk of the tree from every vertex
+        lcf::matrix<Weight> all_pairs() const {
+            Vertex n = size();
+            std::vector<std::vector<std::pair<Vertex, Weight>>> tree(n);
+            for (Vertex vtx = 1; vtx < n; ++vtx) {
+                tree[vtx].emplace_back(parent[vtx], weight[vtx]);
+                tree[parent[vtx]].emplace_back(vtx, weight[vtx]);
+            }
+            lcf::matrix<Weight> result(n, n, Edge::inf);
+            std::vector<Vertex> stack, from(n);
+            for (Vertex root = 0; root < n; ++root) {
+                stack.assign(1, root); from[root] = graph::nvtx;
+                while (not stack.empty()) {
+                    Vertex vtx = stack.back(); stack.pop_back();
+                    for (auto [child, w] : tree[vtx]) {
+                        if (child == from[vtx]) { continue; }
+                        from[child] = vtx;
+                        result(root, child) = std::min(vtx == root ? Edge::inf : result(root, vtx), w);
+                        stack.emplace_back(child);
+                    }
+                }
+            }
+            return result;
+        }
+        //* tree edge vtx - parent[vtx] of weight[vtx] for every vertex but the root 0
+        std::vector<Vertex> parent;
+        std::vector<Weight> weight;
+    private:
+        void build(Graph&& g, size_t thread_num) {
+            Vertex n = g.size();
+            if (n < 2) { return; }
+            thread_num = std::clamp<size_t>(thread_num, 1, n - 1);
+            auto capacities = edge_capacities(g);
+            std::vector<std::unique_ptr<iterative_danic<Graph>>> solvers(thread_num);
+            for (size_t idx = 1; idx < thread_num; ++idx)
+            { solvers[idx] = std::make_unique<iterative_danic<Graph>>(clone_with_capacities(g, capacities), 0, 0); }
+            solvers[0] = std::make_unique<iterative_danic<Graph>>(std::move(g), 0, 0); //* source == terminal, no flow yet
+            std::atomic<Vertex> next(1), done(1);
+            parallel_for(thread_num, [&](size_t idx) {
+                auto& solver = *solvers[idx];
+                auto cut = [&](Vertex source, Vertex terminal) {
+                    for (Vertex u = 0; u < n; ++u) {
+                        for (auto iter = solver.residual_graph.begin(u), end = solver.residual_graph.end(); iter != end; ++iter)
+                        { (*iter).value() = capacities[iter.vtx]; }
+                    }
+                    return solver.push(source, terminal);
+                };
+                for (Vertex vtx; (vtx = next.fetch_add(1, std::memory_order_relaxed)) < n;) {
+                    Vertex target = std::atomic_ref(parent[vtx]).load(std::memory_order_relaxed);
+                    Weight flow = cut(vtx, target);
+                    for (Vertex current; (current = done.load(std::memory_order_acquire)) != vtx;) { done.wait(current); }
+                    if (parent[vtx] != target) { target = parent[vtx]; flow = cut(vtx, target); }
+                    weight[vtx] = flow;
+                    auto side = minimum_cut_side(solver.residual_graph, vtx);
+                    for (Vertex later = vtx + 1; later < n; ++later) {
+                        std::atomic_ref p(parent[later]);
+                        if (side[later] and p.load(std::memory_order_relaxed) == target) { p.store(vtx, std::memory_order_relaxed); }
+                    }
+                    done.store(vtx + 1, std::memory_order_release); done.notify_all();
+                }
+            });
+            for (Vertex vtx = 1; vtx < n; ++vtx) { depth[vtx] = depth[parent[vtx]] + 1; } //* parent[vtx] < vtx
+        }
+        std::vector<Vertex> depth;
+    };
+}
+
+#endif
@@ -1,40 +1,111 @@
 #ifndef GRAPH_H
 #define GRAPH_H
+#include <cassert>
+#include <span>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
 namespace lcf {
     namespace graph {
         using vertex = int;
         static constexpr vertex nvtx = -1;
+        //* solvers following operator~ call this, a csr::graph built without pairing has no reverse edges
+        template <typename Graph>
+        void require_paired(const Graph& g, const char* solver) {
+            if constexpr (requires { g.paired(); }) {
+                if (not g.paired()) { throw std::invalid_argument(std::string(solver) + ": edges of the graph are not paired"); }
+            }
+        }
     }
 }
 
 namespace lcf {
     namespace cfs {
-        template<typename Edge>
+        //* edges interleaved in one array, iterators refer to the edges themselves
+        template <typename Edge>
+        struct aos_storage {
+            using vertex = lcf::graph::vertex;
+            using reference = Edge&;
+            using const_reference = const Edge&;
+            struct stash_type { };
+            template <typename... Args>
+            void emplace_back(vertex head, vertex next, Args&&... args)
+            { edges.emplace_back(head, next, std::forward<Args>(args)...); }
+            void reserve(size_t edge_num) { edges.reserve(edge_num); }
+            size_t size() const { return edges.size(); }
+            reference at(vertex e, stash_type&) { return edges[e]; }
+            const_reference at(vertex e, stash_type&) const { return edges[e]; }
+            reference reverse(vertex e) { return edges[e ^ 1]; }
+            const_reference reverse(vertex e) const { return edges[e ^ 1]; }
+            vertex head(vertex e) const { return edges[e]._head; }
+            vertex next(vertex e) const { return edges[e]._next; }
+            void set_head(vertex e, vertex head) { edges[e]._head = head; }
+            void set_next(vertex e, vertex next) { edges[e]._next = next; }
+            //* the i-th edge becomes the order[i]-th edge before
+            void permute(const std::vector<vertex>& order) {
+                std::vector<Edge> result; result.reserve(edges.size());
+                for (auto e : order) { result.emplace_back(std::move(edges[e])); }
+                edges = std::move(result);
+            }
+            std::vector<Edge> edges;
+        };
+        template <typename Edge>
+        struct soa_storage;
+
+        template <typename Edge, template <typename> typename Storage = aos_storage>
         struct graph {
             using edge_type = Edge;
             using vertex = lcf::graph::vertex;
+            using storage_type = Storage<Edge>;
             graph(size_t vertex_num, size_t edge_num = 128) : map(vertex_num, lcf::graph::nvtx)
-            { edges.reserve(edge_num); }
+            { store.reserve(edge_num); }
             graph(graph&& other) = default;
             vertex emplace_vertex() { map.emplace_back(lcf::graph::nvtx); return map.size() - 1; }
             template<typename... Args>
             void emplace_edge(vertex tail, vertex head, Args&&... args) {
-                edges.emplace_back(head, map[tail], std::forward<Args>(args)...);
-                map[tail] = edges.size() - 1;
+                store.emplace_back(head, map[tail], std::forward<Args>(args)...);
+                map[tail] = store.size() - 1;
             }
             size_t size() const { return map.size(); }
+            /*
+            * vertex u becomes new_label[u]; edge pairs (k, k ^ 1) are stored in the order of the new tail of k
+            * so that out edges of a vertex are close in memory, then the lists are linked as if re-emplaced
+            */
+            void relabel(const std::vector<vertex>& new_label) {
+                size_t m = store.size();
+                std::vector<vertex> tail(m);
+                for (vertex u = 0, n = size(); u < n; ++u) {
+                    for (auto e = map[u]; e != lcf::graph::nvtx; e = store.next(e)) { tail[e] = new_label[u]; }
+                }
+                std::vector<size_t> count(size() + 1);
+                for (size_t k = 0; k < m; k += 2) { ++count[tail[k] + 1]; }
+                for (size_t u = 0, n = size(); u < n; ++u) { count[u + 1] += count[u]; }
+                std::vector<vertex> pair_order((m + 1) / 2), order, new_tail; order.reserve(m); new_tail.reserve(m);
+                for (size_t k = 0; k < m; k += 2) { pair_order[count[tail[k]]++] = k; }
+                for (auto k : pair_order) {
+                    for (size_t e = k, last = std::min<size_t>(k + 2, m); e < last; ++e)
+                    { order.emplace_back(e); new_tail.emplace_back(tail[e]); }
+                }
+                store.permute(order);
+                std::fill(map.begin(), map.end(), lcf::graph::nvtx);
+                for (vertex e = 0; e < static_cast<vertex>(m); ++e) {
+                    store.set_head(e, new_label[store.head(e)]);
+                    store.set_next(e, map[new_tail[e]]); map[new_tail[e]] = e;
+                }
+            }
             template <typename Pointer>
             struct _iterator {
-                using reference = std::conditional_t<std::is_const_v<std::remove_pointer_t<Pointer>>, const edge_type&, edge_type&>;
+                using reference = std::conditional_t<std::is_const_v<std::remove_pointer_t<Pointer>>,
+                    typename storage_type::const_reference, typename storage_type::reference>;
                 _iterator(Pointer p = nullptr, vertex v = lcf::graph::nvtx) : graph_pointer(p), vtx(v) { }
-                reference operator*() const { return graph_pointer->edges[vtx]; }
-                reference operator~() const { return graph_pointer->edges[vtx ^ 1]; }
-                void operator++() { vtx = graph_pointer->edges[vtx]._next; }
+                reference operator*() const { return graph_pointer->store.at(vtx, edge); }
+                decltype(auto) operator~() const { return graph_pointer->store.reverse(vtx); }
+                void operator++() { vtx = graph_pointer->store.next(vtx); }
                 bool operator!=(const _iterator& rhs) const { return vtx != rhs.vtx; }
                 Pointer graph_pointer;
                 vertex vtx;
+                [[no_unique_address]] mutable typename storage_type::stash_type edge;
             };
             template <typename Iterator>
             struct iterator_wrapper {
@@ -53,11 +124,11 @@ namespace lcf {
             auto operator[](vertex vtx) const { return iterator_wrapper(begin(vtx), end()); }
         private:
             std::vector<vertex> map;
-            std::vector<edge_type> edges;
+            storage_type store;
         };
         struct unweighted_edge {
             using vertex = lcf::graph::vertex;
-            template<typename> friend class graph;
+            template<typename> friend struct aos_storage;
             unweighted_edge(vertex head, vertex next): _head(head), _next(next) { }
             vertex head() const { return _head; }
         protected:
@@ -93,6 +164,15 @@ namespace lcf {
             { adjacent_list[tail].emplace_back(head, std::forward<Args>(args)...); }
             vertex emplace_vertex() { adjacent_list.emplace_back(); return adjacent_list.size() - 1; }
             size_t size() const { return adjacent_list.size(); }
+            //* vertex u becomes new_label[u], rows are moved rather than copied
+            void relabel(const std::vector<vertex>& new_label) {
+                adjacent_list_type result(adjacent_list.size());
+                for (vertex u = 0, n = size(); u < n; ++u) {
+                    for (auto& edge : adjacent_list[u]) { edge._head = new_label[edge._head]; }
+                    result[new_label[u]] = std::move(adjacent_list[u]);
+                }
+                adjacent_list = std::move(result);
+            }
             reference& operator[](vertex tail) { return adjacent_list[tail]; }
             const_reference operator[](vertex tail) const { return adjacent_list[tail]; }
         private:
@@ -100,6 +180,7 @@ namespace lcf {
         };
         struct unweighted_edge {
             using vertex = lcf::graph::vertex;
+            template<typename> friend class graph;
             unweighted_edge(vertex head): _head(head) { }
             vertex head() const { return _head; }
         protected:
@@ -119,6 +200,318 @@ namespace lcf {
     }
 }
 
+namespace lcf {
+    namespace csr {
+        /*
+        * compressed sparse row: out edges of vertex u are [offsets[u], offsets[u + 1]) in heads and weights;
+        * the topology is immutable once built, only edge values can be modified;
+        * edges are paired as in cfs::graph (emplacement index k with k ^ 1), so operator~ of the iterator
+        * is available when built from cfs::graph or from an edge list emplaced in pairs,
+        * otherwise paired() is false, operator~ asserts and the flow solvers throw invalid_argument;
+        * Container can be a view such as mapped_array to iterate arrays that the graph does not own
+        */
+        template <typename Edge, template <typename...> typename Container = std::vector>
+        class graph {
+        public:
+            using edge_type = Edge;
+            using vertex = lcf::graph::vertex;
+            using storage_type = typename edge_type::storage_type;
+            static constexpr bool weighted = not std::is_same_v<storage_type, std::nullptr_t>;
+            graph() : offsets(1, 0) { }
+            graph(Container<size_t>&& offset_list, Container<vertex>&& head_list,
+                Container<storage_type>&& weight_list = {}, Container<size_t>&& reverse_list = {})
+            : offsets(std::move(offset_list)), heads(std::move(head_list)),
+              weights(std::move(weight_list)), reverse(std::move(reverse_list)) { }
+            //* edges should be lcf::graph::weighted_edge or lcf::graph::unweighted_edge
+            template <typename ListEdge>
+            graph(size_t vertex_num, const std::vector<ListEdge>& edges)
+            : offsets(vertex_num + 1, 0), heads(edges.size()), reverse(edges.size()) {
+                if constexpr (weighted) { weights.resize(edges.size()); }
+                for (const auto& edge : edges) { ++offsets[edge._u + 1]; }
+                for (size_t u = 0; u < vertex_num; ++u) { offsets[u + 1] += offsets[u]; }
+                std::vector<size_t> position(offsets.begin(), offsets.end() - 1);
+                for (size_t k = 0, m = edges.size(); k < m; ++k) {
+                    auto idx = position[edges[k]._u]++;
+                    heads[idx] = edges[k]._v;
+                    if constexpr (weighted and ListEdge::has_value::value) { weights[idx] = edges[k]._w; }
+                    reverse[k] = idx; //* temporarily records where the k-th edge goes
+                }
+                pair_edges(reverse);
+            }
+            template <typename OtherEdge, template <typename> typename Storage>
+            graph(const cfs::graph<OtherEdge, Storage>& g) : offsets(g.size() + 1, 0) {
+                for (vertex u = 0, n = g.size(); u < n; ++u) {
+                    for (auto iter = g.begin(u), end = g.end(); iter != end; ++iter) { ++offsets[u + 1]; }
+                    offsets[u + 1] += offsets[u];
+                }
+                heads.resize(offsets.back()); reverse.resize(offsets.back());
+                if constexpr (weighted) { weights.resize(offsets.back()); }
+                std::vector<size_t> position(offsets.back());
+                for (vertex u = 0, n = g.size(); u < n; ++u) {
+                    auto idx = offsets[u];
+                    for (auto iter = g.begin(u), end = g.end(); iter != end; ++iter, ++idx) {
+                        heads[idx] = (*iter).head();
+                        if constexpr (weighted) { weights[idx] = (*iter).value(); }
+                        position[iter.vtx] = idx;
+                    }
+                }
+                pair_edges(position);
+            }
+            //* any graph with size() and operator[]; operator~ is not available
+            template <typename Graph>
+            requires (not std::is_same_v<std::remove_cvref_t<Graph>, graph>)
+            graph(const Graph& g) : offsets(g.size() + 1, 0) {
+                for (vertex u = 0, n = g.size(); u < n; ++u) {
+                    offsets[u + 1] = offsets[u];
+                    for (auto iter = g[u].begin(), end = g[u].end(); iter != end; ++iter) { ++offsets[u + 1]; }
+                }
+                heads.reserve(offsets.back());
+                if constexpr (weighted) { weights.reserve(offsets.back()); }
+                for (vertex u = 0, n = g.size(); u < n; ++u) {
+                    for (const auto& edge : g[u]) {
+                        heads.emplace_back(edge.head());
+                        if constexpr (weighted) { weights.emplace_back(edge.value()); }
+                    }
+                }
+            }
+            size_t size() const { return offsets.size() - 1; }
+            size_t edge_size() const { return heads.size(); }
+            size_t degree(vertex vtx) const { return offsets[vtx + 1] - offsets[vtx]; }
+            bool paired() const { return reverse.size() == heads.size(); }
+            const Container<size_t>& offset_list() const { return offsets; }
+            const Container<vertex>& head_list() const { return heads; }
+            const Container<storage_type>& weight_list() const { return weights; }
+            const Container<size_t>& reverse_list() const { return reverse; }
+            template <typename Pointer>
+            struct _iterator {
+                using reference = std::conditional_t<std::is_const_v<std::remove_pointer_t<Pointer>>, const edge_type&, edge_type&>;
+                _iterator(Pointer p = nullptr, size_t i = npos, size_t l = npos) : graph_pointer(p), idx(i), last(l) { }
+                reference operator*() const { return edge = graph_pointer->edge_at(idx); }
+                edge_type operator~() const
+                { assert(graph_pointer->paired()); return graph_pointer->edge_at(graph_pointer->reverse[idx]); }
+                void operator++() { ++idx; }
+                //* end() carries no vertex, so comparing with it tests the row end recorded in the iterator
+                bool operator!=(const _iterator& rhs) const { return rhs.last == npos ? idx != last : idx != rhs.idx; }
+                Pointer graph_pointer;
+                size_t idx, last;
+                mutable edge_type edge;
+            };
+            template <typename Iterator>
+            struct iterator_wrapper {
+                iterator_wrapper(Iterator b, Iterator e) : _begin(b), _end(e) { }
+                Iterator begin() const { return _begin; }
+                Iterator end() const { return  _end; }
+                Iterator _begin, _end;
+            };
+            using iterator = _iterator<graph*>;
+            using const_iterator = _iterator<const graph*>;
+            iterator begin(vertex vtx) { return iterator(this, offsets[vtx], offsets[vtx + 1]); }
+            const_iterator begin(vertex vtx) const { return const_iterator(this, offsets[vtx], offsets[vtx + 1]); }
+            iterator end(vertex vtx) { return iterator(this, offsets[vtx + 1], offsets[vtx + 1]); }
+            const_iterator end(vertex vtx) const { return const_iterator(this, offsets[vtx + 1], offsets[vtx + 1]); }
+            iterator end() { return iterator{}; }
+            const_iterator end() const { return const_iterator{}; }
+            auto operator[](vertex vtx) { return iterator_wrapper(begin(vtx), end(vtx)); }
+            auto operator[](vertex vtx) const { return iterator_wrapper(begin(vtx), end(vtx)); }
+        private:
+            static constexpr size_t npos = -1;
+            edge_type edge_at(size_t idx) const {
+                auto head = heads.data() + idx;
+                if constexpr (weighted) { return edge_type(head, const_cast<storage_type*>(weights.data()) + idx); }
+                else { return edge_type(head); }
+            }
+            //* position[k] is the index of the k-th emplaced edge; an unpaired last edge points to itself
+            void pair_edges(const std::vector<size_t>& position) {
+                std::vector<size_t> result(position.size());
+                for (size_t k = 0, m = position.size(); k < m; ++k)
+                { result[position[k]] = (k ^ 1) < m ? position[k ^ 1] : position[k]; }
+                reverse = std::move(result);
+            }
+            Container<size_t> offsets;
+            Container<vertex> heads;
+            Container<storage_type> weights;
+            Container<size_t> reverse;
+        };
+        //* edges of csr::graph are views into the arrays of graph
+        struct unweighted_edge {
+            using vertex = lcf::graph::vertex;
+            using storage_type = std::nullptr_t;
+            unweighted_edge(const vertex* head = nullptr) : _head(head) { }
+            vertex head() const { return *_head; }
+        protected:
+            const vertex* _head;
+        };
+        template <typename Weight = long long>
+        struct weighted_edge : unweighted_edge {
+            using weight_type = Weight;
+            using storage_type = Weight;
+            weighted_edge(const vertex* head = nullptr, weight_type* weight = nullptr)
+            : unweighted_edge(head), _weight(weight) { }
+            weight_type& value() { return *_weight; }
+            const weight_type& value() const { return *_weight; }
+            weight_type* _weight;
+            static constexpr weight_type inf = std::numeric_limits<weight_type>::max() >> 2;
+        };
+        //* the csr edge carrying the same weight as Edge
+        template <typename Edge>
+        struct edge_of { using type = unweighted_edge; };
+        template <typename Edge>
+        requires requires { typename Edge::weight_type; }
+        struct edge_of<Edge> { using type = weighted_edge<typename Edge::weight_type>; };
+    }
+}
+
+namespace lcf {
+    namespace cfs {
+        /*
+        * heads, next links and weights in separate arrays, so walking a list touches only heads and nexts
+        * until a weight is asked for; iterators hand out csr edges viewing the arrays;
+        * indices stay graph::vertex (32-bit) and edges k and k ^ 1 are still paired
+        */
+        template <typename Edge>
+        struct soa_storage {
+            using vertex = lcf::graph::vertex;
+            using stash_type = typename csr::edge_of<Edge>::type;
+            using weight_storage = typename stash_type::storage_type;
+            using reference = stash_type&;
+            using const_reference = const stash_type&;
+            static constexpr bool weighted = not std::is_same_v<weight_storage, std::nullptr_t>;
+            template <typename... Args>
+            void emplace_back(vertex head, vertex next, Args&&... args) {
+                heads.emplace_back(head); nexts.emplace_back(next);
+                if constexpr (weighted) { weights.emplace_back(std::forward<Args>(args)...); }
+            }
+            void reserve(size_t edge_num) {
+                heads.reserve(edge_num); nexts.reserve(edge_num);
+                if constexpr (weighted) { weights.reserve(edge_num); }
+            }
+            size_t size() const { return heads.size(); }
+            stash_type view(vertex e) const {
+                if constexpr (weighted) { return stash_type(heads.data() + e, const_cast<weight_storage*>(weights.data()) + e); }
+                else { return stash_type(heads.data() + e); }
+            }
+            reference at(vertex e, stash_type& stash) { return stash = view(e); }
+            const_reference at(vertex e, stash_type& stash) const { return stash = view(e); }
+            stash_type reverse(vertex e) const { return view(e ^ 1); }
+            vertex head(vertex e) const { return heads[e]; }
+            vertex next(vertex e) const { return nexts[e]; }
+            void set_head(vertex e, vertex head) { heads[e] = head; }
+            void set_next(vertex e, vertex next) { nexts[e] = next; }
+            void permute(const std::vector<vertex>& order) {
+                auto apply = [&order](auto& array) {
+                    std::remove_reference_t<decltype(array)> result; result.reserve(array.size());
+                    for (auto e : order) { result.emplace_back(std::move(array[e])); }
+                    array = std::move(result);
+                };
+                apply(heads);
+                if constexpr (weighted) { apply(weights); }
+            }
+            std::vector<vertex> heads, nexts;
+            std::vector<weight_storage> weights;
+        };
+    }
+}
+
+namespace lcf {
+    namespace dyn {
+        /*
+        * every vertex owns a slab [begin, begin + capacity) of one edge array, its edges fill the front of the slab;
+        * a full slab moves to the end of the array with doubled capacity and leaves its old cells as garbage;
+        * erasing swaps the last edge of the row into the hole, so edge order inside a row is not kept
+        * and edges are not paired for operator~;
+        * compact() rebuilds the array with tight slabs, it runs by itself once garbage outgrows the live edges
+        */
+        template <typename Edge>
+        class graph {
+        public:
+            using edge_type = Edge;
+            using vertex = lcf::graph::vertex;
+            graph(size_t vertex_num, size_t edge_num = 128) : slabs(vertex_num), garbage(0), live(0)
+            { edges.reserve(edge_num); }
+            vertex emplace_vertex() { slabs.emplace_back(edges.size(), 0, 0); return slabs.size() - 1; }
+            template <typename... Args>
+            void emplace_edge(vertex tail, vertex head, Args&&... args) {
+                if (slabs[tail].size == slabs[tail].capacity) { grow(tail); }
+                auto& s = slabs[tail];
+                edges[s.begin + s.size++] = edge_type(head, std::forward<Args>(args)...);
+                ++live;
+            }
+            //* erase the idx-th edge of tail in O(1)
+            void erase_edge_at(vertex tail, size_t idx) {
+                auto& s = slabs[tail];
+                edges[s.begin + idx] = std::move(edges[s.begin + --s.size]);
+                --live;
+            }
+            //* erase one edge from tail to head, return false if there is none
+            bool erase_edge(vertex tail, vertex head) {
+                const auto& s = slabs[tail];
+                for (size_t idx = 0; idx < s.size; ++idx) {
+                    if (edges[s.begin + idx].head() == head) { erase_edge_at(tail, idx); return true; }
+                }
+                return false;
+            }
+            void compact() {
+                std::vector<edge_type> result; result.reserve(live);
+                for (auto& s : slabs) {
+                    auto begin = result.size();
+                    std::move(edges.begin() + s.begin, edges.begin() + s.begin + s.size, std::back_inserter(result));
+                    s.begin = begin; s.capacity = s.size;
+                }
+                edges = std::move(result);
+                garbage = 0;
+            }
+            size_t size() const { return slabs.size(); }
+            size_t edge_size() const { return live; }
+            size_t degree(vertex tail) const { return slabs[tail].size; }
+            std::span<edge_type> operator[](vertex tail)
+            { return std::span<edge_type>(edges.data() + slabs[tail].begin, slabs[tail].size); }
+            std::span<const edge_type> operator[](vertex tail) const
+            { return std::span<const edge_type>(edges.data() + slabs[tail].begin, slabs[tail].size); }
+        private:
+            struct slab {
+                slab(size_t b = 0, size_t s = 0, size_t c = 0) : begin(b), size(s), capacity(c) { }
+                size_t begin, size, capacity;
+            };
+            void grow(vertex tail) {
+                if (garbage > live + 1024) { compact(); }
+                auto& s = slabs[tail];
+                auto capacity = std::max<size_t>(s.capacity * 2, 4);
+                if (s.begin + s.capacity == edges.size()) { edges.resize(s.begin + capacity); } //* the last slab grows in place
+                else {
+                    auto begin = edges.size();
+                    edges.resize(begin + capacity);
+                    std::move(edges.begin() + s.begin, edges.begin() + s.begin + s.size, edges.begin() + begin);
+                    garbage += s.capacity;
+                    s.begin = begin;
+                }
+                s.capacity = capacity;
+            }
+            std::vector<slab> slabs;
+            std::vector<edge_type> edges;
+            size_t garbage, live;
+        };
+        struct unweighted_edge {
+            using vertex = lcf::graph::vertex;
+            unweighted_edge(vertex head = lcf::graph::nvtx): _head(head) { }
+            vertex head() const { return _head; }
+        protected:
+            vertex _head;
+        };
+        template <typename Weight = long long>
+        struct weighted_edge : unweighted_edge {
+            using weight_type = Weight;
+            weighted_edge() = default;
+            template <typename... Args>
+            weighted_edge(vertex head, Args&&... args)
+            : unweighted_edge(head), _weight(std::forward<Args>(args)...) { }
+            weight_type& value() { return _weight; }
+            const weight_type& value() const { return _weight; }
+            weight_type _weight;
+            static constexpr weight_type inf = std::numeric_limits<weight_type>::max() >> 1;
+        };
+    }
+}
+
 namespace lcf {
     namespace am {
         template <typename T>
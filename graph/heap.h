@@ -1,6 +1,10 @@
 #ifndef HEAP_H
 #define HEAP_H
 #include <ext/pb_ds/priority_queue.hpp>
+#include <array>
+#include <bit>
+#include <limits>
+#include <vector>
 
 namespace lcf {
     template <typename T, typename CmpFunctor>
@@ -17,4 +21,107 @@ namespace lcf {
     using mergeable_binomial_heap = __gnu_pbds::priority_queue<T, CmpFunctor, __gnu_pbds::rc_binomial_heap_tag>;
 }
 
-#endif
\ No newline at end of file
+namespace lcf {
+    /*
+    * monotone min-heap keyed by the non-negative integer T::first (T itself if integral),
+    * pushed keys must not be smaller than the last popped key, which holds in dijkstra;
+    * bucket i holds keys whose highest bit differing from the last popped key is bit i - 1,
+    * so every element moves down at most once per bit; CmpFunctor is only for the Heap interface
+    */
+    template <typename T, typename CmpFunctor = std::greater<T>>
+    class radix_heap {
+        static constexpr auto key(const T& value) {
+            if constexpr (std::is_integral_v<T>) { return static_cast<std::make_unsigned_t<T>>(value); }
+            else { return static_cast<std::make_unsigned_t<typename T::first_type>>(value.first); }
+        }
+        using key_type = decltype(key(std::declval<T>()));
+    public:
+        radix_heap() : _size(0), last(0) { }
+        bool empty() const { return _size == 0; }
+        size_t size() const { return _size; }
+        void push(const T& value) { buckets[bucket_of(key(value))].push_back(value); ++_size; }
+        const T& top() { refill(); return buckets[0].back(); }
+        void pop() { refill(); buckets[0].pop_back(); --_size; }
+        //* the buckets keep their capacity for the next use
+        void clear() { for (auto& bucket : buckets) { bucket.clear(); } _size = 0; last = 0; }
+    private:
+        size_t bucket_of(key_type k) const { return std::bit_width(static_cast<key_type>(k ^ last)); }
+        void refill() {
+            if (not buckets[0].empty()) { return; }
+            size_t idx = 1;
+            while (buckets[idx].empty()) { ++idx; }
+            last = key(buckets[idx].front());
+            for (const auto& value : buckets[idx]) { last = std::min(last, key(value)); }
+            for (const auto& value : buckets[idx]) { buckets[bucket_of(key(value))].push_back(value); }
+            buckets[idx].clear();
+        }
+        std::array<std::vector<T>, std::numeric_limits<key_type>::digits + 1> buckets;
+        size_t _size;
+        key_type last;
+    };
+}
+
+namespace lcf {
+    /*
+    * d-ary heap of T = (key, index) with position tracking, index is a vertex in [0, n);
+    * push of an index already in the heap is a decrease-key, kept only if it improves the entry,
+    * so the heap holds every index at most once and its size is bounded by |V|;
+    * CmpFunctor orders like std::priority_queue: std::greater makes a min-heap
+    */
+    template <typename T, typename CmpFunctor = std::greater<T>, size_t Arity = 4>
+    class indexed_heap {
+        static constexpr size_t npos = -1;
+    public:
+        bool empty() const { return heap.empty(); }
+        size_t size() const { return heap.size(); }
+        void reserve(size_t n) { heap.reserve(n); if (position.size() < n) { position.resize(n, npos); } }
+        bool contains(size_t idx) const { return idx < position.size() and position[idx] != npos; }
+        const T& top() const { return heap.front(); }
+        void push(const T& value) {
+            size_t idx = value.second;
+            if (idx >= position.size()) { position.resize(std::max(idx + 1, position.size() * 2), npos); }
+            size_t pos = position[idx];
+            if (pos == npos) { pos = heap.size(); heap.push_back(value); }
+            else if (cmp(heap[pos], value)) { heap[pos] = value; }
+            else { return; }
+            sift_up(pos);
+        }
+        void pop() {
+            position[heap.front().second] = npos;
+            T last = std::move(heap.back()); heap.pop_back();
+            if (not heap.empty()) { sift_down(0, std::move(last)); }
+        }
+        void clear() { for (const auto& value : heap) { position[value.second] = npos; } heap.clear(); }
+    private:
+        void place(size_t pos, T&& value) { position[value.second] = pos; heap[pos] = std::move(value); }
+        void sift_up(size_t pos) {
+            T value = std::move(heap[pos]);
+            while (pos) {
+                size_t parent = (pos - 1) / Arity;
+                if (not cmp(heap[parent], value)) { break; }
+                place(pos, std::move(heap[parent])); pos = parent;
+            }
+            place(pos, std::move(value));
+        }
+        void sift_down(size_t pos, T&& value) {
+            for (size_t n = heap.size(), first; (first = pos * Arity + 1) < n;) {
+                size_t best = first;
+                for (size_t child = first + 1, last = std::min(first + Arity, n); child < last; ++child)
+                { if (cmp(heap[best], heap[child])) { best = child; } }
+                if (not cmp(value, heap[best])) { break; }
+                place(pos, std::move(heap[best])); pos = best;
+            }
+            place(pos, std::move(value));
+        }
+        std::vector<T> heap;
+        std::vector<size_t> position;
+        [[no_unique_address]] CmpFunctor cmp;
+    };
+
+    template <typename T, typename CmpFunctor>
+    using indexed_4ary_heap = indexed_heap<T, CmpFunctor, 4>;
+    template <typename T, typename CmpFunctor>
+    using indexed_8ary_heap = indexed_heap<T, CmpFunctor, 8>;
+}
+
+#endif
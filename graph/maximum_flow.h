@@ -1,7 +1,11 @@
 #ifndef MAXIMUM_FLOW
 #define MAXIMUM_FLOW
 #include "graph.h"
+#include "builder.h"
+#include <algorithm>
+#include <bit>
 #include <queue>
+#include <tr2/dynamic_bitset>
 
 namespace lcf {
     template <typename ResidualGraph>
@@ -11,6 +15,47 @@ namespace lcf {
         for (const auto& edge : residual_graph[source]) { result += edge.value(); }
         return result;
     }
+
+    //* capacity of every edge indexed by its emplace order in cfs::graph
+    template <typename Graph>
+    std::vector<typename Graph::edge_type::weight_type> edge_capacities(const Graph& graph) {
+        std::vector<typename Graph::edge_type::weight_type> result;
+        for (graph::vertex u = 0, n = graph.size(); u < n; ++u) {
+            for (auto iter = graph.begin(u), end = graph.end(); iter != end; ++iter) {
+                if (static_cast<size_t>(iter.vtx) >= result.size()) { result.resize(iter.vtx + 1); }
+                result[iter.vtx] = (*iter).value();
+            }
+        }
+        return result;
+    }
+
+    //* a cfs::graph with the same edge numbering whose edge idx carries capacities[idx], cfs::graph can not be copied
+    template <typename Graph>
+    Graph clone_with_capacities(const Graph& g, const std::vector<typename Graph::edge_type::weight_type>& capacities) {
+        std::vector<std::pair<graph::vertex, graph::vertex>> ends(capacities.size());
+        for (graph::vertex u = 0, n = g.size(); u < n; ++u) {
+            for (auto iter = g.begin(u), end = g.end(); iter != end; ++iter) { ends[iter.vtx] = std::make_pair(u, (*iter).head()); }
+        }
+        Graph result(g.size(), ends.size());
+        for (size_t idx = 0; idx < ends.size(); ++idx) { result.emplace_edge(ends[idx].first, ends[idx].second, capacities[idx]); }
+        return result;
+    }
+
+    //* source side of the minimum cut: vertices still reachable from source through residual edges after a maximum flow
+    template <typename ResidualGraph>
+    std::tr2::dynamic_bitset<> minimum_cut_side(const ResidualGraph& residual_graph, graph::vertex source) {
+        std::tr2::dynamic_bitset<> side(residual_graph.size());
+        std::vector<graph::vertex> stack{source}; side[source] = true;
+        while (not stack.empty()) {
+            auto vtx = stack.back(); stack.pop_back();
+            for (const auto& edge : residual_graph[vtx]) {
+                auto child = edge.head();
+                if (side[child] or not edge.value()) { continue; }
+                side[child] = true; stack.emplace_back(child);
+            }
+        }
+        return side;
+    }
 }
 
 namespace lcf {
@@ -25,8 +70,10 @@ namespace lcf {
         edmonds_karp(Graph&& g, Vertex source, Vertex terminal)
         : residual_graph(std::move(g)), flow(residual_graph.size()), trace(residual_graph.size())
         { build_residual_graph(source, terminal); }
-        void build_residual_graph(Vertex source, Vertex terminal)
-        { while (bfs(source, terminal)) { update(source, terminal); } }
+        void build_residual_graph(Vertex source, Vertex terminal) {
+            graph::require_paired(residual_graph, "edmonds_karp");
+            while (bfs(source, terminal)) { update(source, terminal); }
+        }
         bool bfs(Vertex source, Vertex terminal) {
             std::fill(flow.begin(), flow.end(), 0); flow[source] = Edge::inf;
             std::queue<Vertex> queue; queue.push(source);
@@ -69,8 +116,10 @@ namespace lcf {
         danic(Graph&& g, Vertex source, Vertex terminal)
         : residual_graph(std::move(g)), depth(residual_graph.size()), useful(residual_graph.size())
         { build_residual_graph(source, terminal); } 
-        void build_residual_graph(Vertex source, Vertex terminal)
-        { while (bfs(source, terminal)) { dfs_update(source, terminal, Edge::inf); } }
+        void build_residual_graph(Vertex source, Vertex terminal) {
+            graph::require_paired(residual_graph, "danic");
+            while (bfs(source, terminal)) { dfs_update(source, terminal, Edge::inf); }
+        }
         bool bfs(Vertex source, Vertex terminal) {
             for (Vertex u = residual_graph.size() - 1; u != -1; --u)
             { useful[u] = residual_graph.begin(u); }
@@ -109,6 +158,159 @@ namespace lcf {
     };
 }
 
+namespace lcf {
+    /*
+    * danic without recursion: the augmenting path is kept as a stack of edges, a vertex whose current edge
+    * runs out is a dead end and leaves the level graph, after an augmentation the path is cut back to the tail
+    * of its first saturated edge; with scaling (integral weights only) the level graphs only admit residual
+    * edges of at least threshold, which starts at the highest power of 2 not above the largest capacity and halves
+    */
+    template <typename Graph>
+    struct iterative_danic {
+        using Vertex = typename Graph::vertex;
+        using Edge = typename Graph::edge_type;
+        using Weight = typename Edge::weight_type;
+        iterative_danic(const Graph& g, Vertex source, Vertex terminal, bool scaling = false)
+        : residual_graph(g), depth(g.size()), useful(g.size())
+        { build_residual_graph(source, terminal, scaling); }
+        iterative_danic(Graph&& g, Vertex source, Vertex terminal, bool scaling = false)
+        : residual_graph(std::move(g)), depth(residual_graph.size()), useful(residual_graph.size())
+        { build_residual_graph(source, terminal, scaling); }
+        void build_residual_graph(Vertex source, Vertex terminal, bool scaling) {
+            graph::require_paired(residual_graph, "iterative_danic");
+            threshold = Weight{};
+            if (source == terminal) { return; }
+            if constexpr (std::is_integral_v<Weight>) {
+                if (scaling) {
+                    for (Vertex u = residual_graph.size() - 1; u != -1; --u)
+                    { for (const auto& edge : residual_graph[u]) { threshold = std::max(threshold, edge.value()); } }
+                    threshold = std::bit_floor(static_cast<std::make_unsigned_t<Weight>>(threshold));
+                }
+            }
+            do { push(source, terminal); } while ((threshold /= 2) > Weight{});
+        }
+        //* send at most limit from one vertex to another through the residual graph, returns the amount sent
+        Weight push(Vertex from, Vertex to, Weight limit = Edge::inf) {
+            Weight total{};
+            while (total < limit and bfs(from, to)) { total += augment(from, to, limit - total); }
+            return total;
+        }
+        bool admissible(Weight capacity) const { return capacity and capacity >= threshold; }
+        bool bfs(Vertex source, Vertex terminal) {
+            for (Vertex u = residual_graph.size() - 1; u != -1; --u)
+            { useful[u] = residual_graph.begin(u); }
+            std::fill(depth.begin(), depth.end(), 0); depth[source] = 1;
+            queue.clear(); queue.emplace_back(source);
+            for (size_t front = 0; front < queue.size(); ++front) {
+                auto vtx = queue[front];
+                for (const auto& edge : residual_graph[vtx]) {
+                    auto child = edge.head();
+                    if (depth[child] or not admissible(edge.value())) { continue; }
+                    depth[child] = depth[vtx] + 1;
+                    if (child == terminal) { return true; }
+                    queue.emplace_back(child);
+                }
+            }
+            return false;
+        }
+        Weight augment(Vertex source, Vertex terminal, Weight limit) {
+            path.clear();
+            Weight total{};
+            for (Vertex vtx = source; ;) {
+                if (vtx == terminal) {
+                    Weight flow = limit - total;
+                    for (auto& iter : path) { flow = std::min(flow, (*iter).value()); }
+                    size_t cut = path.size();
+                    for (size_t idx = 0; idx < path.size(); ++idx) {
+                        auto& iter = path[idx];
+                        (*iter).value() -= flow; (~iter).value() += flow;
+                        if (cut == path.size() and not admissible((*iter).value())) { cut = idx; }
+                    }
+                    if ((total += flow) == limit) { return total; }
+                    vtx = (~path[cut]).head(); path.resize(cut);
+                    continue;
+                }
+                auto iter = useful[vtx], end = residual_graph.end();
+                for (; iter != end; ++iter) {
+                    if (depth[(*iter).head()] == depth[vtx] + 1 and admissible((*iter).value())) { break; }
+                }
+                useful[vtx] = iter;
+                if (iter != end) { path.emplace_back(iter); vtx = (*iter).head(); continue; }
+                depth[vtx] = 0; //* dead end, no longer in the level graph
+                if (path.empty()) { return total; }
+                vtx = (~path.back()).head(); path.pop_back();
+                ++useful[vtx];
+            }
+        }
+        Graph residual_graph;
+        Weight threshold;
+        std::vector<int> depth;
+        std::vector<Vertex> queue;
+        std::vector<typename Graph::iterator> useful, path;
+    };
+}
+
+namespace lcf {
+    /*
+    * maximum flow kept up to date under capacity changes: edges are named by their emplace order as in cfs::graph,
+    * so edge k is paired with k ^ 1; an increase only adds residual capacity, a decrease below the current flow
+    * cancels the overflow and leaves an excess at the tail and a deficit at the head, the excess is sent
+    * to the head, then to terminal, then back to source, the deficit is filled from source, then from terminal;
+    * resume() augments from the previous flow again, so a batch of changes costs one resume;
+    * edges are reached through cfs::graph iterators, so Graph must be a cfs::graph
+    */
+    template <typename Graph>
+    requires builder::is_cfs<Graph>::value
+    struct incremental_max_flow {
+        using Vertex = typename Graph::vertex;
+        using Edge = typename Graph::edge_type;
+        using Weight = typename Edge::weight_type;
+        incremental_max_flow(const Graph& g, Vertex source, Vertex terminal)
+        : capacities(edge_capacities(g)), solver(clone_with_capacities(g, capacities), source, terminal),
+          residual_graph(solver.residual_graph), source(source), terminal(terminal) { }
+        incremental_max_flow(Graph&& g, Vertex source, Vertex terminal)
+        : capacities(edge_capacities(g)), solver(std::move(g), source, terminal),
+          residual_graph(solver.residual_graph), source(source), terminal(terminal) { }
+        Weight capacity(Vertex idx) const { return capacities[idx]; }
+        Weight flow(Vertex idx) { return capacities[idx] - (*edge(idx)).value(); }
+        Weight maximum_flow() {
+            Weight result{};
+            for (auto iter = residual_graph.begin(terminal), end = residual_graph.end(); iter != end; ++iter)
+            { result += (*iter).value() - capacities[iter.vtx]; }
+            return result;
+        }
+        //* the flow stays valid but may be no longer maximum until resume()
+        void set_capacity(Vertex idx, Weight capacity) {
+            auto iter = edge(idx);
+            (*iter).value() += capacity - capacities[idx];
+            capacities[idx] = capacity;
+            Weight overflow = -(*iter).value();
+            if (overflow <= Weight{}) { return; }
+            (*iter).value() = 0; (~iter).value() -= overflow;
+            Vertex tail = (~iter).head(), head = (*iter).head();
+            if (tail == head) { return; }
+            Weight excess = overflow, deficit = overflow;
+            auto settle = [&](Weight& rest, Vertex from, Vertex to) {
+                if (rest and from != to) { rest -= solver.push(from, to, rest); }
+            };
+            if (tail != source and tail != terminal and head != source and head != terminal) {
+                Weight rerouted = solver.push(tail, head, overflow);
+                excess -= rerouted; deficit -= rerouted;
+            }
+            if (tail != source and tail != terminal) { settle(excess, tail, terminal); settle(excess, tail, source); }
+            if (head != source and head != terminal) { settle(deficit, source, head); settle(deficit, terminal, head); }
+        }
+        void resume() { if (source != terminal) { solver.push(source, terminal); } }
+    private:
+        typename Graph::iterator edge(Vertex idx) { return typename Graph::iterator(&residual_graph, idx); }
+        std::vector<Weight> capacities;
+        iterative_danic<Graph> solver;
+    public:
+        Graph& residual_graph;
+        Vertex source, terminal;
+    };
+}
+
 namespace lcf {
     template <typename Graph>
     struct isap {
@@ -123,6 +325,7 @@ namespace lcf {
           count(residual_graph.size() + 3), useful(residual_graph.size())
         { build_residual_graph(source, terminal); }
         void build_residual_graph(Vertex source, Vertex terminal) {
+            graph::require_paired(residual_graph, "isap");
             if (not bfs_init(source, terminal)) { return; }
             while (height[source] <= residual_graph.size()) {
                 for (Vertex u = residual_graph.size() - 1; u != -1; --u)
@@ -168,4 +371,155 @@ namespace lcf {
     };
 }
 
-#endif
\ No newline at end of file
+namespace lcf {
+    /*
+    * highest label push-relabel: the active vertex of the highest height is discharged first;
+    * heights start as bfs distances to terminal in the residual graph and are recomputed that way
+    * once the relabel work passes vertex_num * 6 + edge_num / 2 (global relabeling);
+    * when the last vertex of a height is relabeled, every vertex above it can no longer reach terminal
+    * and is lifted to vertex_num at once (gap heuristic);
+    * the first phase ends with the maximum flow into terminal, the second returns the remaining excess
+    * to source with heights vertex_num + distance to source, so residual_graph holds a valid flow as with isap
+    */
+    template <typename Graph>
+    struct hlpp {
+        using Vertex = typename Graph::vertex;
+        using Edge = typename Graph::edge_type;
+        using Weight = typename Edge::weight_type;
+        hlpp(const Graph& g, Vertex source, Vertex terminal)
+        : residual_graph(g) { build_residual_graph(source, terminal); }
+        hlpp(Graph&& g, Vertex source, Vertex terminal)
+        : residual_graph(std::move(g)) { build_residual_graph(source, terminal); }
+        void build_residual_graph(Vertex s, Vertex t) {
+            graph::require_paired(residual_graph, "hlpp");
+            Vertex n = residual_graph.size();
+            source = s; terminal = t;
+            height.assign(n, 0); excess.assign(n, 0); useful.resize(n);
+            active.assign(2 * n + 1, {}); all.assign(n, graph::nvtx);
+            list_next.assign(n, graph::nvtx); list_prev.assign(n, graph::nvtx);
+            edge_num = 0;
+            for (Vertex u = 0; u < n; ++u) { for ([[maybe_unused]] const auto& edge : residual_graph[u]) { ++edge_num; } }
+            if (source == terminal) { return; }
+            for (auto iter = residual_graph.begin(source), end = residual_graph.end(); iter != end; ++iter) {
+                Weight capacity = (*iter).value();
+                if (not capacity) { continue; }
+                (*iter).value() -= capacity; (~iter).value() += capacity;
+                excess[(*iter).head()] += capacity;
+            }
+            first_phase = true; limit = n;
+            global_relabel();
+            discharge_all();
+            first_phase = false; limit = 2 * n;
+            global_relabel();
+            discharge_all();
+        }
+        Weight maximum_flow() const { return excess[terminal]; }
+        //* bfs from terminal in the first phase and from source in the second, unreached vertices get limit
+        void global_relabel() {
+            Vertex n = residual_graph.size();
+            Vertex root = first_phase ? terminal : source;
+            std::ranges::fill(height, limit);
+            for (auto& bucket : active) { bucket.clear(); }
+            std::ranges::fill(all, graph::nvtx);
+            height[root] = first_phase ? 0 : n;
+            max_active = max_height = 0;
+            std::vector<Vertex> queue; queue.reserve(n); queue.emplace_back(root);
+            for (size_t front = 0; front < queue.size(); ++front) {
+                Vertex vtx = queue[front];
+                for (auto iter = residual_graph.begin(vtx), end = residual_graph.end(); iter != end; ++iter) {
+                    auto child = (*iter).head();
+                    if (height[child] != limit or child == source or child == terminal or not (~iter).value()) { continue; }
+                    height[child] = height[vtx] + 1;
+                    queue.emplace_back(child);
+                }
+            }
+            if (first_phase) { height[source] = n; }
+            for (size_t idx = 1; idx < queue.size(); ++idx) {
+                Vertex vtx = queue[idx];
+                useful[vtx] = residual_graph.begin(vtx);
+                link(vtx);
+                if (excess[vtx]) { activate(vtx); }
+            }
+            work = 0;
+        }
+        void discharge_all() {
+            Vertex n = residual_graph.size();
+            while (max_active >= 0) {
+                auto& bucket = active[max_active];
+                if (bucket.empty()) { --max_active; continue; }
+                Vertex vtx = bucket.back(); bucket.pop_back();
+                if (height[vtx] != max_active or not excess[vtx]) { continue; }
+                discharge(vtx);
+                if (first_phase and work > static_cast<size_t>(n) * 6 + edge_num / 2) { global_relabel(); }
+            }
+        }
+        void discharge(Vertex vtx) {
+            while (true) {
+                for (auto iter = useful[vtx], end = residual_graph.end(); iter != end; ++iter) {
+                    useful[vtx] = iter;
+                    auto child = (*iter).head();
+                    Weight capacity = (*iter).value();
+                    if (not capacity or height[child] + 1 != height[vtx]) { continue; }
+                    Weight flow = std::min(excess[vtx], capacity);
+                    (*iter).value() -= flow; (~iter).value() += flow;
+                    bool inactive = not excess[child];
+                    excess[child] += flow; excess[vtx] -= flow;
+                    if (inactive) { activate(child); }
+                    if (not excess[vtx]) { return; }
+                }
+                Vertex old_height = height[vtx], new_height = limit;
+                for (auto iter = residual_graph.begin(vtx), end = residual_graph.end(); iter != end; ++iter) {
+                    if ((*iter).value()) { new_height = std::min(new_height, height[(*iter).head()] + 1); }
+                    ++work;
+                }
+                work += 12;
+                unlink(vtx);
+                if (first_phase and all[old_height] == graph::nvtx) { height[vtx] = limit; gap(old_height); return; }
+                height[vtx] = new_height;
+                if (new_height >= limit) { return; }
+                useful[vtx] = residual_graph.begin(vtx);
+                link(vtx);
+                max_active = new_height; //* vtx is still the highest active vertex
+            }
+        }
+        //* no vertex is left at empty_height, the vertices above it are cut off from terminal
+        void gap(Vertex empty_height) {
+            for (Vertex h = empty_height; h <= max_height; ++h) {
+                for (Vertex vtx = all[h]; vtx != graph::nvtx; vtx = list_next[vtx]) { height[vtx] = limit; }
+                all[h] = graph::nvtx; active[h].clear();
+            }
+            max_height = max_active = empty_height - 1;
+        }
+        void activate(Vertex vtx) {
+            if (vtx == source or vtx == terminal or height[vtx] >= limit) { return; }
+            active[height[vtx]].emplace_back(vtx);
+            max_active = std::max(max_active, height[vtx]);
+        }
+        //* lists of all vertices by height are kept in the first phase only, for the gap heuristic
+        void link(Vertex vtx) {
+            if (not first_phase) { return; }
+            Vertex h = height[vtx];
+            list_prev[vtx] = graph::nvtx; list_next[vtx] = all[h];
+            if (all[h] != graph::nvtx) { list_prev[all[h]] = vtx; }
+            all[h] = vtx;
+            max_height = std::max(max_height, h);
+        }
+        void unlink(Vertex vtx) {
+            if (not first_phase) { return; }
+            if (list_prev[vtx] != graph::nvtx) { list_next[list_prev[vtx]] = list_next[vtx]; }
+            else { all[height[vtx]] = list_next[vtx]; }
+            if (list_next[vtx] != graph::nvtx) { list_prev[list_next[vtx]] = list_prev[vtx]; }
+        }
+        Graph residual_graph;
+        Vertex source, terminal, limit, max_active, max_height;
+        bool first_phase;
+        std::vector<Vertex> height;
+        std::vector<Weight> excess;
+        std::vector<typename Graph::iterator> useful;
+        std::vector<std::vector<Vertex>> active;
+        std::vector<Vertex> all, list_next, list_prev;
+        size_t edge_num, work;
+    };
+}
+
+#endif
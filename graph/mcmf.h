@@ -2,7 +2,9 @@
 #define MCMF_H
 #include "graph.h"
 #include "heap.h"
+#include "maximum_flow.h"
 #include <tr2/dynamic_bitset>
+#include <cmath>
 #include <ranges>
 
 namespace lcf {
@@ -20,6 +22,7 @@ namespace lcf {
         maximum_flow(0), minimum_cost(0)
         { build_residual_graph(); }
         void build_residual_graph() {
+            graph::require_paired(residual_graph, "danic_mcmf");
             while (spfa()) {
                 Flow flow = dfs_update(source, inf_flow);
                 maximum_flow += flow;
@@ -85,6 +88,7 @@ namespace lcf {
         maximum_flow(0), minimum_cost(0)
         { build_residual_graph(); }
         void build_residual_graph() {
+            graph::require_paired(residual_graph, "primal_dual_mcmf");
             if (not spfa()) { return; }
             while (dijkstra()) {
                 for (int i = residual_graph.size() - 1; i != -1; --i) { cheapest[i] += positive_cheapest[i]; }
@@ -115,7 +119,8 @@ namespace lcf {
             std::ranges::fill(positive_cheapest, inf_cost); positive_cheapest[source] = 0;
             bitset.reset(); //* true if vertex is processed
             using Pair = std::pair<Cost, Vertex>;
-            lcf::std_binary_heap<Pair, std::greater<Pair>> heap; heap.push(std::make_pair(0, source));
+            lcf::indexed_4ary_heap<Pair, std::greater<Pair>> heap; heap.reserve(residual_graph.size());
+            heap.push(std::make_pair(0, source));
             while (not heap.empty()) {
                 auto [_, vtx] = heap.top(); heap.pop();
                 for (const auto& edge : residual_graph[vtx]) {
@@ -173,6 +178,7 @@ namespace lcf {
         maximum_flow(0), minimum_cost(0)
         { build_residual_graph(); }
         void build_residual_graph() {
+            graph::require_paired(residual_graph, "ek_mcmf");
             while (spfa()) {
                 maximum_flow += flow[terminal];
                 minimum_cost += cheapest[terminal] * flow[terminal];
@@ -219,4 +225,259 @@ namespace lcf {
     };
 }
 
+namespace lcf {
+    /*
+    * arcs of a cfs::graph residual graph in arrays indexed by edge index, arc k is paired with k ^ 1 as in the graph;
+    * integral costs are kept in at least long long; write_back stores the residual capacities
+    * into the graph and returns the cost of the flow
+    */
+    template <typename Graph>
+    struct mcmf_arcs {
+        using Vertex = typename Graph::vertex;
+        using Weight = typename Graph::edge_type::weight_type;
+        using Flow = typename Weight::first_type;
+        using Cost = typename Weight::second_type;
+        using Scaled = std::conditional_t<std::is_integral_v<Cost>, std::common_type_t<Cost, long long>, Cost>;
+        void read(const Graph& g) {
+            for (Vertex u = 0, n = g.size(); u < n; ++u) {
+                for (auto iter = g.begin(u), end = g.end(); iter != end; ++iter) {
+                    size_t k = iter.vtx;
+                    if (k >= tail.size()) { resize((k | 1) + 1); }
+                    tail[k] = u; head[k] = (*iter).head();
+                    std::tie(capacity[k], cost[k]) = (*iter).value();
+                }
+            }
+        }
+        Cost write_back(Graph& g) const {
+            Cost result{};
+            for (Vertex u = 0, n = g.size(); u < n; ++u) {
+                for (auto iter = g.begin(u), end = g.end(); iter != end; ++iter) {
+                    size_t k = iter.vtx;
+                    auto& [residual, c] = (*iter).value();
+                    if (c > 0 or (c == 0 and k % 2 == 0)) { result += (residual - capacity[k]) * c; }
+                    residual = capacity[k];
+                }
+            }
+            return result;
+        }
+        //* maximum flow on the arcs by iterative_danic on a cfs::graph of the capacities with the same edge numbering
+        Flow send_maximum_flow(Vertex vertex_num, Vertex source, Vertex terminal) {
+            using flow_graph = cfs::graph<cfs::weighted_edge<Flow>>;
+            flow_graph g(vertex_num, tail.size());
+            for (size_t k = 0; k < tail.size(); ++k) { g.emplace_edge(tail[k], head[k], capacity[k]); }
+            iterative_danic<flow_graph> solver(std::move(g), source, source); //* source == terminal, no flow yet
+            Flow result = source == terminal ? Flow{} : solver.push(source, terminal);
+            for (Vertex u = 0; u < vertex_num; ++u) {
+                for (auto iter = solver.residual_graph.begin(u), end = solver.residual_graph.end(); iter != end; ++iter)
+                { capacity[iter.vtx] = (*iter).value(); }
+            }
+            return result;
+        }
+        void resize(size_t size) { tail.resize(size); head.resize(size); capacity.resize(size); cost.resize(size); }
+        std::vector<Vertex> tail, head;
+        std::vector<Flow> capacity;
+        std::vector<Scaled> cost;
+    };
+}
+
+namespace lcf {
+    /*
+    * network simplex on the circulation made of the residual graph, an arc terminal -> source of cost -M,
+    * M = vertex_num * max |cost| + 1, so that every unit of flow pays off before any cost is saved,
+    * and an arc of cost 0 from every vertex into an extra root; the flow of the root arcs stays 0,
+    * so they only start the spanning tree; the entering arc is the most negative residual arc of reduced cost
+    * in a block of about sqrt(arc_num) arcs scanned in turn (block search), potentials are recomputed lazily
+    * from the tree after every pivot; the flow is a minimum cost circulation, so negative circles are saturated;
+    * the leaving arc is the last blocking arc of the circle from the apex, which keeps the tree strongly feasible;
+    * integral costs and potentials are kept in at least long long, M and the potentials reach about vertex_num^2 * max |cost|
+    */
+    template <typename Graph>
+    struct network_simplex_mcmf : mcmf_arcs<Graph> {
+        using Vertex = typename Graph::vertex;
+        using Weight = typename Graph::edge_type::weight_type;
+        using Flow = typename Weight::first_type;
+        using Cost = typename Weight::second_type;
+        using Scaled = typename mcmf_arcs<Graph>::Scaled;
+        using mcmf_arcs<Graph>::tail, mcmf_arcs<Graph>::head, mcmf_arcs<Graph>::capacity, mcmf_arcs<Graph>::cost;
+        static constexpr Flow inf_flow = std::numeric_limits<Flow>::max() >> 2;
+        network_simplex_mcmf(Graph& g, Vertex s, Vertex t)
+        : residual_graph(g), source(s), terminal(t), maximum_flow(0), minimum_cost(0)
+        { build_residual_graph(); }
+        void build_residual_graph() {
+            if (source == terminal) { return; }
+            Vertex n = residual_graph.size();
+            this->read(residual_graph);
+            size_t edge_num = tail.size();
+            Flow total{}; Scaled max_cost{};
+            for (size_t k = 0; k < edge_num; ++k) {
+                if (tail[k] == source) { total = std::min(inf_flow, total + capacity[k]); }
+                max_cost = std::max(max_cost, cost[k] < 0 ? -cost[k] : cost[k]);
+            }
+            root = n;
+            Scaled big = max_cost * n + 1;
+            emplace_arc(terminal, source, total, -big);
+            father.resize(n + 1); father_arc.resize(n + 1);
+            for (Vertex u = 0; u < n; ++u) {
+                emplace_arc(u, root, inf_flow, 0);
+                father[u] = root; father_arc[u] = tail.size() - 1; //* root -> u
+            }
+            potential.assign(n + 1, 0); stamp.assign(n + 1, 0); mark.assign(n + 1, 0);
+            now = mark_now = 0;
+            size_t arc_num = tail.size(), block = std::max<size_t>(std::sqrt(arc_num), 16);
+            for (size_t next = 0, clean = 0; clean < arc_num;) { //* clean counts arcs scanned since the last pivot
+                size_t best = arc_num; Scaled best_cost = 0;
+                for (size_t idx = 0; idx < block and clean < arc_num; ++idx, ++clean, next = next + 1 == arc_num ? 0 : next + 1) {
+                    if (not capacity[next]) { continue; }
+                    Scaled reduced = cost[next] + get_potential(tail[next]) - get_potential(head[next]);
+                    if (reduced < best_cost) { best_cost = reduced; best = next; }
+                }
+                if (best != arc_num) { pivot(best); clean = 0; }
+            }
+            minimum_cost = this->write_back(residual_graph);
+            maximum_flow = capacity[edge_num + 1];
+        }
+        //* potential[u] = potential[father[u]] + cost[father_arc[u]], recomputed up from the last vertex stamped after a pivot
+        Scaled get_potential(Vertex vtx) {
+            path.clear();
+            for (; vtx != root and stamp[vtx] != now; vtx = father[vtx]) { path.emplace_back(vtx); }
+            for (auto iter = path.rbegin(); iter != path.rend(); ++iter)
+            { potential[*iter] = potential[father[*iter]] + cost[father_arc[*iter]]; stamp[*iter] = now; }
+            return potential[path.empty() ? vtx : path.front()];
+        }
+        //* push around the circle of arc and the tree path from its head back to its tail, then swap arc in for the blocking tree arc
+        void pivot(size_t arc) {
+            Vertex u = tail[arc], v = head[arc], lca = v;
+            ++mark_now;
+            for (Vertex x = u; x != root; x = father[x]) { mark[x] = mark_now; }
+            mark[root] = mark_now;
+            while (mark[lca] != mark_now) { lca = father[lca]; }
+            Flow delta = capacity[arc];
+            Vertex blocking = graph::nvtx; bool on_head_side = false;
+            for (Vertex x = v; x != lca; x = father[x]) { //* up from v through father_arc ^ 1
+                if (capacity[father_arc[x] ^ 1] <= delta) { delta = capacity[father_arc[x] ^ 1]; blocking = x; on_head_side = true; }
+            }
+            for (Vertex x = u; x != lca; x = father[x]) { //* down to u through father_arc
+                if (capacity[father_arc[x]] < delta) { delta = capacity[father_arc[x]]; blocking = x; on_head_side = false; }
+            }
+            if (delta) {
+                capacity[arc] -= delta; capacity[arc ^ 1] += delta;
+                for (Vertex x = v; x != lca; x = father[x]) { capacity[father_arc[x] ^ 1] -= delta; capacity[father_arc[x]] += delta; }
+                for (Vertex x = u; x != lca; x = father[x]) { capacity[father_arc[x]] -= delta; capacity[father_arc[x] ^ 1] += delta; }
+            }
+            if (blocking == graph::nvtx) { return; }
+            //* the subtree of blocking is hung below the other end of arc, the path up to blocking is reversed
+            Vertex child = on_head_side ? v : u, parent = on_head_side ? u : v;
+            size_t down = on_head_side ? arc : arc ^ 1;
+            while (true) {
+                Vertex old_father = father[child]; size_t old_arc = father_arc[child];
+                father[child] = parent; father_arc[child] = down;
+                if (child == blocking) { break; }
+                parent = child; down = old_arc ^ 1; child = old_father;
+            }
+            ++now;
+        }
+        void emplace_arc(Vertex from, Vertex to, Flow cap, Scaled c) {
+            tail.emplace_back(from); head.emplace_back(to); capacity.emplace_back(cap); cost.emplace_back(c);
+            tail.emplace_back(to); head.emplace_back(from); capacity.emplace_back(0); cost.emplace_back(-c);
+        }
+        Graph& residual_graph;
+        Vertex source, terminal, root;
+        std::vector<Vertex> father, path;
+        std::vector<size_t> father_arc, stamp, mark;
+        std::vector<Scaled> potential;
+        size_t now, mark_now;
+        Flow maximum_flow;
+        Cost minimum_cost;
+    };
+}
+
+namespace lcf {
+    /*
+    * cost scaling push-relabel (Goldberg-Tarjan): a maximum flow is found first by iterative_danic on the residual arcs,
+    * then the circulation on its residual graph is made optimal with costs multiplied by vertex_num + 1;
+    * every refine(eps) saturates the arcs of negative reduced cost and discharges the excess in FIFO order
+    * along arcs of negative reduced cost, a vertex without one lowers its price until one has -eps;
+    * eps starts at the largest scaled cost and is divided by scaling until it reaches 1;
+    * costs must be integral, scaled costs and prices are kept in at least long long
+    * since they grow to about vertex_num^2 * max |cost|
+    */
+    template <typename Graph>
+    struct cost_scaling_mcmf : mcmf_arcs<Graph> {
+        using Vertex = typename Graph::vertex;
+        using Weight = typename Graph::edge_type::weight_type;
+        using Flow = typename Weight::first_type;
+        using Cost = typename Weight::second_type;
+        using Scaled = typename mcmf_arcs<Graph>::Scaled;
+        using mcmf_arcs<Graph>::tail, mcmf_arcs<Graph>::head, mcmf_arcs<Graph>::capacity, mcmf_arcs<Graph>::cost;
+        static_assert(std::is_integral_v<Cost>, "cost scaling needs integral costs");
+        cost_scaling_mcmf(Graph& g, Vertex s, Vertex t, Cost scaling = 8)
+        : residual_graph(g), source(s), terminal(t), maximum_flow(0), minimum_cost(0)
+        { build_residual_graph(std::max<Cost>(scaling, 2)); }
+        void build_residual_graph(Cost scaling) {
+            Vertex n = residual_graph.size();
+            this->read(residual_graph);
+            maximum_flow = this->send_maximum_flow(n, source, terminal);
+            first.assign(n + 1, 0); arcs.resize(tail.size());
+            for (auto u : tail) { ++first[u + 1]; }
+            for (Vertex u = 0; u < n; ++u) { first[u + 1] += first[u]; }
+            current.assign(first.begin(), first.end() - 1);
+            for (size_t k = 0; k < tail.size(); ++k) { arcs[current[tail[k]]++] = k; }
+            current.resize(n); queue.resize(n);
+            Scaled eps = 0;
+            for (auto& c : cost) { c *= n + 1; eps = std::max(eps, c < 0 ? -c : c); }
+            price.assign(n, 0); excess.assign(n, 0); in_queue.resize(n);
+            while (eps > 1) { eps = std::max<Scaled>(1, eps / scaling); refine(eps); }
+            minimum_cost = this->write_back(residual_graph);
+        }
+        Scaled reduced_cost(size_t k) const { return cost[k] + price[tail[k]] - price[head[k]]; }
+        void refine(Scaled eps) {
+            Vertex n = residual_graph.size();
+            for (size_t k = 0; k < tail.size(); ++k) {
+                if (not capacity[k] or reduced_cost(k) >= 0) { continue; }
+                excess[tail[k]] -= capacity[k]; excess[head[k]] += capacity[k];
+                capacity[k ^ 1] += capacity[k]; capacity[k] = 0;
+            }
+            size_t front = 0, count = 0; //* ring buffer, in_queue keeps at most n vertices in it
+            auto enqueue = [&](Vertex vtx) { in_queue[vtx] = true; queue[(front + count++) % n] = vtx; };
+            for (Vertex u = 0; u < n; ++u) {
+                current[u] = first[u];
+                if (excess[u] > 0) { enqueue(u); }
+            }
+            while (count) {
+                Vertex vtx = queue[front]; in_queue[vtx] = false;
+                front = (front + 1) % n; --count;
+                while (excess[vtx] > 0) {
+                    size_t& idx = current[vtx];
+                    for (; idx < first[vtx + 1]; ++idx) {
+                        size_t k = arcs[idx];
+                        if (not capacity[k] or reduced_cost(k) >= 0) { continue; }
+                        Flow flow = std::min(excess[vtx], capacity[k]);
+                        capacity[k] -= flow; capacity[k ^ 1] += flow;
+                        excess[vtx] -= flow; excess[head[k]] += flow;
+                        if (excess[head[k]] > 0 and not in_queue[head[k]]) { enqueue(head[k]); }
+                        if (not excess[vtx]) { break; }
+                    }
+                    if (not excess[vtx]) { break; }
+                    Scaled highest = std::numeric_limits<Scaled>::min();
+                    for (size_t i = first[vtx]; i < first[vtx + 1]; ++i) {
+                        size_t k = arcs[i];
+                        if (capacity[k]) { highest = std::max(highest, price[head[k]] - cost[k]); }
+                    }
+                    price[vtx] = highest - eps;
+                    idx = first[vtx];
+                }
+            }
+        }
+        Graph& residual_graph;
+        Vertex source, terminal;
+        std::vector<Vertex> queue;
+        std::vector<size_t> first, arcs, current;
+        std::vector<Flow> excess;
+        std::vector<Scaled> price;
+        std::vector<char> in_queue;
+        Flow maximum_flow;
+        Cost minimum_cost;
+    };
+}
+
 #endif
\ No newline at end of file
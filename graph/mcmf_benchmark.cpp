@@ -0,0 +1,43 @@
+//* g++ -std=c++20 -O2 -iquote . graph/mcmf_benchmark.cpp Timer.cpp && ./a.out
+#include "graph.h"
+#include "mcmf.h"
+#include "../Timer.h"
+#include <iostream>
+#include <random>
+
+/*
+* complete transportation network: source -> supplier of capacity 1..1000, supplier -> consumer of capacity 10^6
+* and cost 0..10^6 - 1, consumer -> terminal of capacity 1..1000; every solver gets its own copy of the graph
+*/
+int main() {
+    using Edge = lcf::cfs::weighted_edge<std::pair<long long, long long>>;
+    using Graph = lcf::cfs::graph<Edge>;
+    constexpr int supplier_num = 200, consumer_num = 200;
+    constexpr int n = supplier_num + consumer_num + 2, source = n - 2, terminal = n - 1;
+    std::mt19937 engine(2024);
+    std::vector<std::tuple<int, int, long long, long long>> arcs;
+    for (int i = 0; i < supplier_num; ++i) { arcs.emplace_back(source, i, engine() % 1000 + 1, 0); }
+    for (int j = 0; j < consumer_num; ++j) { arcs.emplace_back(supplier_num + j, terminal, engine() % 1000 + 1, 0); }
+    for (int i = 0; i < supplier_num; ++i) {
+        for (int j = 0; j < consumer_num; ++j) { arcs.emplace_back(i, supplier_num + j, 1000000, engine() % 1000000); }
+    }
+    auto make_graph = [&] {
+        Graph graph(n, arcs.size() * 2);
+        for (auto [u, v, capacity, cost] : arcs) {
+            graph.emplace_edge(u, v, std::make_pair(capacity, cost));
+            graph.emplace_edge(v, u, std::make_pair(0LL, -cost));
+        }
+        return graph;
+    };
+    auto run = [&]<template <typename> typename Solver>(const char* name) {
+        auto graph = make_graph();
+        long long flow = 0, cost = 0;
+        lcf::Timer timer;
+        timer.get_runtime([&] { Solver<Graph> solver(graph, source, terminal); flow = solver.maximum_flow; cost = solver.minimum_cost; });
+        std::cout << name << ": flow " << flow << ", cost " << cost << std::endl;
+    };
+    run.operator()<lcf::danic_mcmf>("danic_mcmf");
+    run.operator()<lcf::primal_dual_mcmf>("primal_dual_mcmf");
+    run.operator()<lcf::network_simplex_mcmf>("network_simplex_mcmf");
+    run.operator()<lcf::cost_scaling_mcmf>("cost_scaling_mcmf");
+}
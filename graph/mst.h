@@ -69,7 +69,7 @@ namespace lcf {
     // return [edge_num, mst_weight]
     template <typename Graph,
         template <typename> typename CmpFunctor = std::greater,
-        template <typename...> typename Heap = lcf::std_binary_heap>
+        template <typename...> typename Heap = lcf::indexed_4ary_heap>
     std::pair<size_t, typename Graph::edge_type::weight_type>
     prim(const Graph& graph) {
         using Weight = typename Graph::edge_type::weight_type;
@@ -0,0 +1,24 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+namespace lcf {
+    inline size_t default_thread_num() { return std::max(1u, std::thread::hardware_concurrency()); }
+
+    //* func(thread_idx) runs on thread_num threads, thread 0 is the calling thread
+    template <typename Functor>
+    void parallel_for(size_t thread_num, Functor func) {
+        std::vector<std::thread> threads; threads.reserve(thread_num);
+        for (size_t idx = 1; idx < thread_num; ++idx) { threads.emplace_back(func, idx); }
+        func(size_t{0});
+        for (auto& thread : threads) { thread.join(); }
+    }
+
+    //* [begin, end) of the idx-th part when [0, size) is split evenly into part_num parts
+    inline std::pair<size_t, size_t> split_range(size_t size, size_t part_num, size_t idx)
+    { return std::make_pair(size * idx / part_num, size * (idx + 1) / part_num); }
+}
+
+#endif
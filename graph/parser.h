@@ -0,0 +1,304 @@
+#ifndef PARSER_H
+#define PARSER_H
+#include "graph.h"
+#include "builder.h"
+#include "snapshot.h"
+#include <cmath>
+#include <limits>
+
+namespace lcf {
+    /*
+    * plain: "u v [w]" per line, 0-indexed, lines starting with '#' or '%' are comments, a missing w is 1;
+    * dimacs: "p <problem> n m" and "a u v [w]" lines, 1-indexed, other lines are ignored;
+    * metis: "n m [fmt [ncon]]" then the i-th line lists the neighbours "v [w]" of vertex i, 1-indexed,
+    * '%' lines are comments, every undirected edge is read as the two directed edges listed;
+    * negative ids and, for dimacs and metis, ids beyond the vertex count of the header throw runtime_error;
+    * a pair weight such as pair<flow, cost> for mcmf is read as two numbers
+    */
+    enum class edge_format { plain, dimacs, metis };
+
+    template <typename ListEdge>
+    struct parsed_edges {
+        size_t vertex_num;
+        std::vector<ListEdge> edges;
+    };
+}
+
+namespace lcf {
+    namespace parser {
+        inline bool is_digit(char c) { return static_cast<unsigned char>(c - '0') < 10; }
+        inline bool is_blank(char c) { return c == ' ' or c == '\t' or c == '\r'; }
+        inline const char* skip_blank(const char* p, const char* end)
+        { while (p != end and is_blank(*p)) { ++p; } return p; }
+        inline const char* next_line(const char* p, const char* end) {
+            auto line_end = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            return line_end ? line_end + 1 : end;
+        }
+        inline bool line_end(const char* p, const char* end) { return p == end or *p == '\n'; }
+        //* false on a number out of the range of Integer instead of wrapping around
+        template <typename Integer>
+        bool parse_integer(const char*& p, const char* end, Integer& value) {
+            using Unsigned = std::make_unsigned_t<Integer>;
+            bool negative = false;
+            if (p != end and (*p == '-' or *p == '+')) { negative = *p++ == '-'; }
+            if (p == end or not is_digit(*p)) { return false; }
+            Unsigned limit = static_cast<Unsigned>(std::numeric_limits<Integer>::max());
+            if (negative) { limit = std::is_signed_v<Integer> ? limit + 1 : 0; }
+            Unsigned result = 0;
+            for (; p != end and is_digit(*p); ++p) {
+                Unsigned digit = *p - '0';
+                if (digit > limit or result > (limit - digit) / 10) { return false; }
+                result = result * 10 + digit;
+            }
+            value = static_cast<Integer>(negative ? -result : result);
+            return true;
+        }
+        //* mantissa keeps 19 significant digits and is scaled by a power of ten, not correctly rounded
+        template <typename Floating>
+        bool parse_floating(const char*& p, const char* end, Floating& value) {
+            static constexpr double power[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+                1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+            static constexpr unsigned long long limit = 1'000'000'000'000'000'000ull;
+            bool negative = false, has_digit = false;
+            if (p != end and (*p == '-' or *p == '+')) { negative = *p++ == '-'; }
+            unsigned long long mantissa = 0;
+            int exponent = 0;
+            for (; p != end and is_digit(*p); ++p, has_digit = true) {
+                if (mantissa < limit) { mantissa = mantissa * 10 + (*p - '0'); }
+                else { ++exponent; }
+            }
+            if (p != end and *p == '.') {
+                for (++p; p != end and is_digit(*p); ++p, has_digit = true) {
+                    if (mantissa < limit) { mantissa = mantissa * 10 + (*p - '0'); --exponent; }
+                }
+            }
+            if (not has_digit) { return false; }
+            if (p != end and (*p == 'e' or *p == 'E')) {
+                int e = 0; ++p;
+                if (not parse_integer(p, end, e)) { return false; }
+                exponent += e;
+            }
+            double result = mantissa;
+            if (exponent < 0) { result = -exponent <= 22 ? result / power[-exponent] : result * std::pow(10.0, exponent); }
+            else if (exponent > 0) { result = exponent <= 22 ? result * power[exponent] : result * std::pow(10.0, exponent); }
+            value = negative ? -result : result;
+            return true;
+        }
+        template <typename T>
+        bool parse_number(const char*& p, const char* end, T& value) {
+            p = skip_blank(p, end);
+            if constexpr (std::is_integral_v<T>) { return parse_integer(p, end, value); }
+            else if constexpr (std::is_floating_point_v<T>) { return parse_floating(p, end, value); }
+            else { return parse_number(p, end, value.first) and parse_number(p, end, value.second); }
+        }
+        template <typename ListEdge>
+        struct chunk_result {
+            std::vector<ListEdge> edges;
+            size_t vertex_num = 0;
+        };
+        [[noreturn]] inline void malformed(const char* format)
+        { throw std::runtime_error(std::string("parse_edges: malformed ") + format + " line"); }
+
+        //* one edge "u v [w]" from p, the returned edge is 0-indexed, ids outside [0, vertex_num) are malformed
+        template <typename ListEdge>
+        void parse_edge(const char*& p, const char* end, int base, size_t vertex_num,
+            chunk_result<ListEdge>& result, const char* format)
+        {
+            graph::vertex u, v;
+            if (not parse_number(p, end, u) or not parse_number(p, end, v)) { malformed(format); }
+            u -= base; v -= base;
+            if (u < 0 or v < 0 or static_cast<size_t>(std::max(u, v)) >= vertex_num) { malformed(format); }
+            result.vertex_num = std::max(result.vertex_num, static_cast<size_t>(std::max(u, v)) + 1);
+            if constexpr (ListEdge::has_value::value) {
+                using Weight = decltype(std::declval<ListEdge>()._w);
+                Weight w{};
+                if (not line_end(skip_blank(p, end), end)) { if (not parse_number(p, end, w)) { malformed(format); } }
+                else if constexpr (std::is_arithmetic_v<Weight>) { w = 1; }
+                else { malformed(format); }
+                result.edges.emplace_back(u, v, w);
+            } else { result.edges.emplace_back(u, v); }
+        }
+        template <typename ListEdge>
+        void parse_plain(const char* p, const char* end, chunk_result<ListEdge>& result) {
+            while (p != end) {
+                p = skip_blank(p, end);
+                if (not line_end(p, end) and *p != '#' and *p != '%') { parse_edge(p, end, 0, std::numeric_limits<size_t>::max(), result, "plain"); }
+                p = next_line(p, end); //* continue from where parsing stopped instead of the line start
+            }
+        }
+        //* "p <problem> n m" with q at 'p'
+        inline void parse_dimacs_problem(const char* q, const char* end, size_t& n, size_t& m) {
+            while (q != end and not is_blank(*q) and *q != '\n') { ++q; }
+            q = skip_blank(q, end);
+            while (q != end and not is_blank(*q) and *q != '\n') { ++q; }
+            if (not parse_number(q, end, n) or not parse_number(q, end, m)) { malformed("dimacs"); }
+        }
+        //* n of the "p" line before the first arc, the maximum size_t if there is none
+        inline size_t dimacs_vertex_num(const char* p, const char* end) {
+            for (; p != end; p = next_line(p, end)) {
+                auto q = skip_blank(p, end);
+                if (line_end(q, end)) { continue; }
+                if (*q == 'a') { break; }
+                if (*q == 'p') { size_t n, m; parse_dimacs_problem(q, end, n, m); return n; }
+            }
+            return std::numeric_limits<size_t>::max();
+        }
+        template <typename ListEdge>
+        void parse_dimacs(const char* p, const char* end, size_t vertex_num, chunk_result<ListEdge>& result) {
+            for (; p != end; p = next_line(p, end)) {
+                auto q = skip_blank(p, end);
+                if (line_end(q, end)) { continue; }
+                if (*q == 'a') { ++q; parse_edge(q, end, 1, vertex_num, result, "dimacs"); }
+                else if (*q == 'p') {
+                    size_t n = 0, m = 0;
+                    parse_dimacs_problem(q, end, n, m);
+                    result.vertex_num = std::max(result.vertex_num, n);
+                    result.edges.reserve(m);
+                }
+            }
+        }
+        struct metis_header {
+            size_t vertex_num = 0, edge_num = 0, skip = 0; //* skip: vertex size and weights before neighbours
+            bool edge_weight = false;
+        };
+        template <typename ListEdge>
+        void parse_metis(const char* p, const char* end, const metis_header& header,
+            graph::vertex vtx, chunk_result<ListEdge>& result)
+        {
+            for (; p != end; p = next_line(p, end), ++vtx) {
+                auto q = skip_blank(p, end);
+                if (q != end and *q == '%') { --vtx; continue; }
+                if (static_cast<size_t>(vtx) >= header.vertex_num and not line_end(q, end)) { malformed("metis"); }
+                for (size_t i = 0; i < header.skip; ++i) {
+                    long long ignored;
+                    if (not parse_number(q, end, ignored)) { malformed("metis"); }
+                }
+                for (q = skip_blank(q, end); not line_end(q, end); q = skip_blank(q, end)) {
+                    graph::vertex v;
+                    if (not parse_number(q, end, v) or v < 1 or static_cast<size_t>(v) > header.vertex_num) { malformed("metis"); }
+                    if constexpr (ListEdge::has_value::value) {
+                        using Weight = decltype(std::declval<ListEdge>()._w);
+                        Weight w{};
+                        if (header.edge_weight) { if (not parse_number(q, end, w)) { malformed("metis"); } }
+                        else if constexpr (std::is_arithmetic_v<Weight>) { w = 1; }
+                        result.edges.emplace_back(vtx, v - 1, w);
+                    } else {
+                        if (header.edge_weight) { long long ignored; parse_number(q, end, ignored); }
+                        result.edges.emplace_back(vtx, v - 1);
+                    }
+                }
+            }
+            result.vertex_num = header.vertex_num;
+        }
+        //* returns the first line after the header
+        inline const char* parse_metis_header(const char* p, const char* end, metis_header& header) {
+            for (; p != end; p = next_line(p, end)) {
+                auto q = skip_blank(p, end);
+                if (line_end(q, end) or *q == '%') { continue; }
+                if (not parse_number(q, end, header.vertex_num) or not parse_number(q, end, header.edge_num))
+                { malformed("metis"); }
+                std::string format = "000";
+                size_t ncon = 0;
+                if (q = skip_blank(q, end); not line_end(q, end)) {
+                    auto first = q;
+                    while (not line_end(q, end) and is_digit(*q)) { ++q; }
+                    format = std::string(3 - std::min<size_t>(3, q - first), '0') + std::string(first, q);
+                    if (not parse_number(q, end, ncon)) { ncon = format[1] == '1'; }
+                }
+                header.skip = (format[0] == '1') + (format[1] == '1' ? ncon : 0);
+                header.edge_weight = format[2] == '1';
+                return next_line(p, end);
+            }
+            return end;
+        }
+        inline size_t count_metis_lines(const char* p, const char* end) {
+            size_t count = 0;
+            for (; p != end; p = next_line(p, end)) {
+                auto q = skip_blank(p, end);
+                if (q == end or *q != '%') { ++count; }
+            }
+            return count;
+        }
+    }
+}
+
+namespace lcf {
+    /*
+    * text is split into thread_num chunks at line boundaries and every chunk is parsed on its own thread,
+    * the edges keep the order of the text so that consecutive lines stay paired for operator~;
+    * ListEdge is lcf::graph::weighted_edge or lcf::graph::unweighted_edge
+    */
+    template <typename ListEdge>
+    parsed_edges<ListEdge> parse_edges(const char* begin, const char* end,
+        edge_format format = edge_format::plain, size_t thread_num = default_thread_num())
+    {
+        thread_num = std::clamp<size_t>(thread_num, 1, (end - begin) / 4096 + 1);
+        parser::metis_header header;
+        if (format == edge_format::metis) { begin = parser::parse_metis_header(begin, end, header); }
+        size_t dimacs_vertex_num = format == edge_format::dimacs ? parser::dimacs_vertex_num(begin, end) : 0;
+        std::vector<const char*> bound(thread_num + 1, end);
+        for (size_t idx = 0; idx < thread_num; ++idx) {
+            auto pos = begin + split_range(end - begin, thread_num, idx).first;
+            bound[idx] = idx == 0 ? begin : parser::next_line(std::max(pos - 1, bound[idx - 1]), end);
+        }
+        std::vector<graph::vertex> first_vtx(thread_num + 1);
+        if (format == edge_format::metis) {
+            parallel_for(thread_num, [&](size_t idx)
+            { first_vtx[idx + 1] = parser::count_metis_lines(bound[idx], bound[idx + 1]); });
+            std::partial_sum(first_vtx.begin(), first_vtx.end(), first_vtx.begin());
+        }
+        std::vector<parser::chunk_result<ListEdge>> chunks(thread_num);
+        std::vector<std::exception_ptr> errors(thread_num);
+        parallel_for(thread_num, [&](size_t idx) {
+            try {
+                switch (format) {
+                case edge_format::plain: parser::parse_plain(bound[idx], bound[idx + 1], chunks[idx]); break;
+                case edge_format::dimacs: parser::parse_dimacs(bound[idx], bound[idx + 1], dimacs_vertex_num, chunks[idx]); break;
+                case edge_format::metis: parser::parse_metis(bound[idx], bound[idx + 1], header, first_vtx[idx], chunks[idx]); break;
+                }
+            } catch (...) { errors[idx] = std::current_exception(); }
+        });
+        for (const auto& error : errors) { if (error) { std::rethrow_exception(error); } }
+        std::vector<size_t> position(thread_num + 1);
+        parsed_edges<ListEdge> result{0, {}};
+        for (size_t idx = 0; idx < thread_num; ++idx) {
+            position[idx + 1] = position[idx] + chunks[idx].edges.size();
+            result.vertex_num = std::max(result.vertex_num, chunks[idx].vertex_num);
+        }
+        if (thread_num == 1) { result.edges = std::move(chunks[0].edges); return result; }
+        result.edges.resize(position[thread_num]);
+        parallel_for(thread_num, [&](size_t idx) {
+            std::move(chunks[idx].edges.begin(), chunks[idx].edges.end(), result.edges.begin() + position[idx]);
+            std::vector<ListEdge>().swap(chunks[idx].edges);
+        });
+        return result;
+    }
+
+    template <typename ListEdge>
+    parsed_edges<ListEdge> parse_edges(const std::string& path,
+        edge_format format = edge_format::plain, size_t thread_num = default_thread_num())
+    {
+        mapped_file file(path);
+        return parse_edges<ListEdge>(file.data(), file.data() + file.size(), format, thread_num);
+    }
+
+    //* csr::graph and al::graph go through parallel_build, cfs::graph is emplaced in order
+    template <typename Graph>
+    Graph load_graph(const std::string& path, edge_format format = edge_format::plain,
+        size_t thread_num = default_thread_num())
+    {
+        using Edge = typename Graph::edge_type;
+        using ListEdge = typename builder::list_edge<Edge>::type;
+        auto [vertex_num, edges] = parse_edges<ListEdge>(path, format, thread_num);
+        if constexpr (builder::is_cfs<Graph>::value) {
+            Graph result(vertex_num, edges.size());
+            for (const auto& edge : edges) {
+                if constexpr (ListEdge::has_value::value) { result.emplace_edge(edge._u, edge._v, edge._w); }
+                else { result.emplace_edge(edge._u, edge._v); }
+            }
+            return result;
+        } else { return parallel_build<Graph>(vertex_num, edges, false, thread_num); }
+    }
+}
+
+#endif
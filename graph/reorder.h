@@ -0,0 +1,165 @@
+#ifndef REORDER_H
+#define REORDER_H
+#include "graph.h"
+#include "heap.h"
+#include <cmath>
+#include <numeric>
+#include <tr2/dynamic_bitset>
+
+namespace lcf {
+    /*
+    * every order returns new_label: vertex u is relabeled to new_label[u];
+    * reorder() relabels cfs::graph or al::graph in place, results computed on the relabeled graph
+    * are mapped back to the original vertices by map_back()
+    */
+    enum class reorder_method { bfs, rcm, degree, gorder };
+
+    template <typename Graph>
+    std::vector<int> out_degree(const Graph& graph) {
+        std::vector<int> out_degree(graph.size());
+        for (graph::vertex i = 0, n = graph.size(); i < n; ++i)
+        { for ([[maybe_unused]] const auto& edge : graph[i]) { ++out_degree[i]; } }
+        return out_degree;
+    }
+
+    inline std::vector<graph::vertex> label_of(const std::vector<graph::vertex>& order) {
+        std::vector<graph::vertex> new_label(order.size());
+        for (graph::vertex i = 0, n = order.size(); i < n; ++i) { new_label[order[i]] = i; }
+        return new_label;
+    }
+
+    template <typename T>
+    std::vector<T> map_back(const std::vector<T>& values, const std::vector<graph::vertex>& new_label) {
+        std::vector<T> result; result.reserve(values.size());
+        for (auto label : new_label) { result.emplace_back(values[label]); }
+        return result;
+    }
+}
+
+namespace lcf {
+    //* breadth first order, every component starts from its smallest vertex
+    template <typename Graph>
+    std::vector<graph::vertex> bfs_order(const Graph& graph) {
+        std::vector<graph::vertex> order; order.reserve(graph.size());
+        std::tr2::dynamic_bitset<> visited(graph.size());
+        for (graph::vertex root = 0, n = graph.size(); root < n; ++root) {
+            if (visited[root]) { continue; }
+            visited[root] = true; order.emplace_back(root);
+            for (size_t front = order.size() - 1; front < order.size(); ++front) {
+                for (const auto& edge : graph[order[front]]) {
+                    auto child = edge.head();
+                    if (visited[child]) { continue; }
+                    visited[child] = true;
+                    order.emplace_back(child);
+                }
+            }
+        }
+        return label_of(order);
+    }
+
+    /*
+    * reverse Cuthill-McKee: every component starts from its vertex of minimum degree,
+    * children are visited in increasing degree and the whole order is reversed
+    */
+    template <typename Graph>
+    std::vector<graph::vertex> rcm_order(const Graph& graph) {
+        auto degree = out_degree(graph);
+        std::vector<graph::vertex> by_degree(graph.size()), order; order.reserve(graph.size());
+        std::iota(by_degree.begin(), by_degree.end(), 0);
+        std::stable_sort(by_degree.begin(), by_degree.end(), [&](auto u, auto v) { return degree[u] < degree[v]; });
+        std::tr2::dynamic_bitset<> visited(graph.size());
+        for (auto root : by_degree) {
+            if (visited[root]) { continue; }
+            visited[root] = true; order.emplace_back(root);
+            for (size_t front = order.size() - 1; front < order.size(); ++front) {
+                auto first = order.size();
+                for (const auto& edge : graph[order[front]]) {
+                    auto child = edge.head();
+                    if (visited[child]) { continue; }
+                    visited[child] = true;
+                    order.emplace_back(child);
+                }
+                std::stable_sort(order.begin() + first, order.end(), [&](auto u, auto v) { return degree[u] < degree[v]; });
+            }
+        }
+        std::reverse(order.begin(), order.end());
+        return label_of(order);
+    }
+
+    //* decreasing out degree, hubs are packed at the front
+    template <typename Graph>
+    std::vector<graph::vertex> degree_order(const Graph& graph) {
+        auto degree = out_degree(graph);
+        std::vector<graph::vertex> order(graph.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](auto u, auto v) { return degree[u] > degree[v]; });
+        return label_of(order);
+    }
+
+    /*
+    * Gorder-style greedy: the next vertex maximizes the number of neighbours and siblings
+    * (vertices sharing an in-neighbour) among the last window placed vertices;
+    * in-neighbours with more than sqrt(n) out edges are not counted for siblings;
+    * scores live in a lazy heap, stale entries are dropped when popped
+    */
+    template <typename Graph>
+    std::vector<graph::vertex> gorder_order(const Graph& graph, size_t window = 5) {
+        using Vertex = graph::vertex;
+        using Pair = std::pair<int, Vertex>;
+        Vertex n = graph.size();
+        auto degree = out_degree(graph);
+        std::vector<std::vector<Vertex>> in_list(n);
+        for (Vertex u = 0; u < n; ++u) { for (const auto& edge : graph[u]) { in_list[edge.head()].emplace_back(u); } }
+        int hub = std::sqrt(n) + 1;
+        std::vector<int> score(n);
+        std::tr2::dynamic_bitset<> placed(n);
+        lcf::std_binary_heap<Pair, std::less<Pair>> heap;
+        auto update = [&](Vertex vtx, int delta) {
+            auto change = [&](Vertex v) {
+                if (placed[v]) { return; }
+                score[v] += delta;
+                if (score[v] > 0) { heap.push(std::make_pair(score[v], v)); }
+            };
+            for (const auto& edge : graph[vtx]) { change(edge.head()); }
+            for (auto parent : in_list[vtx]) {
+                change(parent);
+                if (degree[parent] > hub) { continue; }
+                for (const auto& edge : graph[parent]) { if (edge.head() != vtx) { change(edge.head()); } }
+            }
+        };
+        std::vector<Vertex> by_in_degree(n), order; order.reserve(n);
+        std::iota(by_in_degree.begin(), by_in_degree.end(), 0);
+        std::stable_sort(by_in_degree.begin(), by_in_degree.end(),
+            [&](auto u, auto v) { return in_list[u].size() > in_list[v].size(); });
+        for (size_t next = 0; order.size() < static_cast<size_t>(n);) {
+            Vertex vtx = graph::nvtx;
+            while (not heap.empty()) {
+                auto [s, v] = heap.top(); heap.pop();
+                if (not placed[v] and s == score[v]) { vtx = v; break; }
+            }
+            if (vtx == graph::nvtx) { //* no candidate related to the window
+                while (placed[by_in_degree[next]]) { ++next; }
+                vtx = by_in_degree[next];
+            }
+            placed[vtx] = true; order.emplace_back(vtx);
+            update(vtx, 1);
+            if (order.size() > window) { update(order[order.size() - window - 1], -1); }
+        }
+        return label_of(order);
+    }
+
+    template <typename Graph>
+    std::vector<graph::vertex> reorder(Graph& graph, reorder_method method = reorder_method::rcm) {
+        std::vector<graph::vertex> new_label;
+        switch (method) {
+        case reorder_method::bfs: new_label = bfs_order(graph); break;
+        case reorder_method::rcm: new_label = rcm_order(graph); break;
+        case reorder_method::degree: new_label = degree_order(graph); break;
+        case reorder_method::gorder: new_label = gorder_order(graph); break;
+        }
+        graph.relabel(new_label);
+        return new_label;
+    }
+}
+
+#endif
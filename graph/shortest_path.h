@@ -2,57 +2,394 @@
 #define SHORTEST_PATH_H
 #include "graph.h"
 #include "heap.h"
+#include "parallel.h"
+#include "../matrix.h"
+#include <atomic>
+#include <barrier>
+#include <deque>
+#include <numeric>
 #include <tr2/dynamic_bitset>
 
 namespace lcf {
-    template<typename Graph>
-    std::vector<typename Graph::edge_type::weight_type>
-    bellman_ford(const Graph& graph, graph::vertex source) {
+    /*
+    * buffers of a shortest path query kept between queries: a vertex belongs to the current query
+    * only if its stamp equals the query's, so starting a query costs O(1) instead of O(V);
+    * distance() of a vertex untouched by the current query is inf, visited() lists the touched vertices;
+    * marks are per query flags (processed in dijkstra, in queue in spfa), counts are per vertex counters
+    */
+    template <typename Weight, template <typename...> typename Heap = lcf::indexed_4ary_heap>
+    class sssp_workspace {
+    public:
+        using vertex = graph::vertex;
+        using heap_type = Heap<std::pair<Weight, vertex>, std::greater<std::pair<Weight, vertex>>>;
+        sssp_workspace(size_t size = 0) : version(0) { reserve(size); }
+        void reserve(size_t size) {
+            if (size <= distances.size()) { return; }
+            distances.resize(size); counts.resize(size); stamps.resize(size); marks.resize(size); queue.resize(size);
+            if constexpr (requires { heap.reserve(size); }) { heap.reserve(size); }
+        }
+        void start(size_t size, Weight inf_weight) {
+            reserve(size); inf = inf_weight; touched_list.clear();
+            if constexpr (requires { heap.clear(); }) { heap.clear(); }
+            else { heap = heap_type(); }
+            if (++version) { return; }
+            std::ranges::fill(stamps, 0); std::ranges::fill(marks, 0); version = 1;
+        }
+        bool touched(vertex vtx) const { return stamps[vtx] == version; }
+        Weight distance(vertex vtx) const { return touched(vtx) ? distances[vtx] : inf; }
+        void set_distance(vertex vtx, Weight distance) {
+            if (not touched(vtx)) { stamps[vtx] = version; counts[vtx] = 0; touched_list.emplace_back(vtx); }
+            distances[vtx] = distance;
+        }
+        const std::vector<vertex>& visited() const { return touched_list; }
+        bool marked(vertex vtx) const { return marks[vtx] == version; }
+        void mark(vertex vtx) { marks[vtx] = version; }
+        void unmark(vertex vtx) { marks[vtx] = version - 1; }
+        int& count(vertex vtx) { return counts[vtx]; }
+        //* distances of every vertex, for the overloads returning std::vector<Weight>
+        std::vector<Weight> distance_list(size_t size) const {
+            std::vector<Weight> result(size, inf);
+            for (auto vtx : touched_list) { result[vtx] = distances[vtx]; }
+            return result;
+        }
+        heap_type heap;
+        std::vector<vertex> queue; //* ring buffer of capacity size, enough when every vertex is queued at most once
+    private:
+        std::vector<Weight> distances;
+        std::vector<int> counts;
+        std::vector<unsigned> stamps, marks;
+        std::vector<vertex> touched_list;
+        unsigned version;
+        Weight inf;
+    };
+}
+
+namespace lcf {
+    //* only touched vertices are scanned in each round; false if a negative circle is reachable from source
+    template<typename Graph, template <typename...> typename Heap>
+    bool bellman_ford(const Graph& graph, graph::vertex source,
+        sssp_workspace<typename Graph::edge_type::weight_type, Heap>& workspace)
+    {
         using Edge = typename Graph::edge_type;
         using Weight = typename Edge::weight_type;
-        std::vector<Weight> shortest(graph.size(), Edge::inf); shortest[source] = Weight{};
+        workspace.start(graph.size(), Edge::inf); workspace.set_distance(source, Weight{});
         for (int i = 0, n = graph.size(); i < n; ++i) {
             bool updated = false;
-            for (graph::vertex vtx = graph.size() - 1; vtx != -1; --vtx) {
-                if (shortest[vtx] == Edge::inf) { continue; }
+            for (size_t k = 0; k < workspace.visited().size(); ++k) {
+                graph::vertex vtx = workspace.visited()[k];
                 for (const auto& edge : graph[vtx]) {
                     auto child = edge.head();
-                    Weight new_distance = shortest[vtx] + edge.value();
-                    if (shortest[child] <= new_distance) { continue; }
-                    shortest[child] = new_distance;
+                    Weight new_distance = workspace.distance(vtx) + edge.value();
+                    if (workspace.distance(child) <= new_distance) { continue; }
+                    workspace.set_distance(child, new_distance);
                     updated = true;
                 }
             }
-            if (not updated) { return shortest; }
+            if (not updated) { return true; }
         }
-        return std::vector<Weight>{};
+        return false;
+    }
+
+    template<typename Graph>
+    std::vector<typename Graph::edge_type::weight_type>
+    bellman_ford(const Graph& graph, graph::vertex source) {
+        sssp_workspace<typename Graph::edge_type::weight_type> workspace(graph.size());
+        if (not bellman_ford(graph, source, workspace)) { return {}; }
+        return workspace.distance_list(graph.size());
     }
 }
 
 namespace lcf {
+    //* false if a negative circle is reachable from source
+    template<typename Graph, template <typename...> typename Heap>
+    bool spfa(const Graph& graph, graph::vertex source,
+        sssp_workspace<typename Graph::edge_type::weight_type, Heap>& workspace)
+    {
+        using Edge = typename Graph::edge_type;
+        using Weight = typename Edge::weight_type;
+        int vtx_num = graph.size();
+        workspace.start(vtx_num, Edge::inf); workspace.set_distance(source, Weight{});
+        auto& queue = workspace.queue;
+        size_t front = 0, queue_size = 1;
+        queue[front] = source; workspace.mark(source); //* marked if vertex is in the queue
+        while (queue_size) {
+            graph::vertex vtx = queue[front]; front = front + 1 == queue.size() ? 0 : front + 1; --queue_size;
+            workspace.unmark(vtx);
+            for (const auto& edge : graph[vtx]) {
+                graph::vertex child = edge.head();
+                Weight new_distance = workspace.distance(vtx) + edge.value();
+                if (workspace.distance(child) <= new_distance) { continue; }
+                if (workspace.count(vtx) == vtx_num) { return false; }
+                workspace.set_distance(child, new_distance);
+                workspace.count(child) = workspace.count(vtx) + 1;
+                if (workspace.marked(child)) { continue; }
+                queue[(front + queue_size++) % queue.size()] = child;
+                workspace.mark(child);
+            }
+        }
+        return true;
+    }
+
     template<typename Graph>
     std::vector<typename Graph::edge_type::weight_type>
     spfa(const Graph& graph, graph::vertex source) {
+        sssp_workspace<typename Graph::edge_type::weight_type> workspace(graph.size());
+        if (not spfa(graph, source, workspace)) { return {}; }
+        return workspace.distance_list(graph.size());
+    }
+}
+
+namespace lcf {
+    //* the default indexed heap decreases keys in place, other heaps keep stale entries skipped by the marks
+    template<typename Graph, template <typename...> typename Heap>
+    void dijkstra(const Graph& graph, graph::vertex source,
+        sssp_workspace<typename Graph::edge_type::weight_type, Heap>& workspace)
+    {
         using Edge = typename Graph::edge_type;
         using Weight = typename Edge::weight_type;
-        auto vtx_num = graph.size();
-        std::vector<Weight> shortest(vtx_num, Edge::inf); shortest[source] = Weight{};
-        std::vector<int> edge_count(vtx_num);
-        std::queue<graph::vertex> queue; queue.emplace(source);
-        std::tr2::dynamic_bitset<> in_queue(vtx_num, false); in_queue[source] = true;
-        while (not queue.empty()) {
-            graph::vertex vtx = queue.front(); queue.pop();
-            in_queue[vtx] = false;
+        workspace.start(graph.size(), Edge::inf);
+        auto& small_heap = workspace.heap;
+        workspace.set_distance(source, Weight{}); small_heap.push(std::make_pair(Weight{}, source));
+        while (not small_heap.empty()) {
+            auto [_, vtx] = small_heap.top(); small_heap.pop();
+            if (workspace.marked(vtx)) { continue; }
+            else { workspace.mark(vtx); } //* marked if vertex is processed
             for (const auto& edge : graph[vtx]) {
                 graph::vertex child = edge.head();
-                Weight new_distance = shortest[vtx] + edge.value();
-                if (shortest[child] <= new_distance) { continue; }
-                edge_count[child] = edge_count[vtx] + 1;
-                if (edge_count[vtx] == vtx_num) { return std::vector<Weight>{}; }
-                shortest[child] = new_distance;
-                if (in_queue[child]) { continue; }
-                queue.push(child);
-                in_queue[child] = true;
+                Weight new_distance = workspace.distance(vtx) + edge.value();
+                if (workspace.distance(child) <= new_distance) { continue; }
+                workspace.set_distance(child, new_distance);
+                small_heap.push(std::make_pair(new_distance, child));
+            }
+        }
+    }
+
+    template<typename Graph, template <typename...> typename Heap = lcf::indexed_4ary_heap>
+    std::vector<typename Graph::edge_type::weight_type>
+    dijkstra(const Graph& graph, graph::vertex source) {
+        sssp_workspace<typename Graph::edge_type::weight_type, Heap> workspace(graph.size());
+        dijkstra(graph, source, workspace);
+        return workspace.distance_list(graph.size());
+    }
+}
+
+namespace lcf {
+    /*
+    * parallel delta-stepping for non-negative weights: vertices are bucketed by distance / delta,
+    * light edges (weight <= delta) of the current bucket are relaxed repeatedly until it stops changing,
+    * then the heavy edges of every vertex settled in it are relaxed once;
+    * the threads of each phase split the bucket and relax by atomic compare-and-swap on the distances,
+    * the merge of their outputs runs between phases on the completion of a barrier;
+    * delta = Weight{} picks max_weight * vertex_num / edge_num
+    */
+    template<typename Graph>
+    std::vector<typename Graph::edge_type::weight_type>
+    delta_stepping(const Graph& graph, graph::vertex source,
+        typename Graph::edge_type::weight_type delta = {}, size_t thread_num = default_thread_num())
+    {
+        using Edge = typename Graph::edge_type;
+        using Weight = typename Edge::weight_type;
+        using Vertex = graph::vertex;
+        size_t n = graph.size();
+        if (not (delta > Weight{})) {
+            Weight max_weight{}; size_t m = 0;
+            for (Vertex vtx = 0; vtx < static_cast<Vertex>(n); ++vtx)
+            { for (const auto& edge : graph[vtx]) { max_weight = std::max(max_weight, edge.value()); ++m; } }
+            delta = m ? static_cast<Weight>(static_cast<double>(max_weight) * n / m) : Weight{};
+            if (not (delta > Weight{})) { delta = Weight(1); }
+        }
+        thread_num = std::max<size_t>(thread_num, 1);
+        std::vector<Weight> shortest(n, Edge::inf); shortest[source] = Weight{};
+        auto bucket_of = [delta](Weight distance) { return static_cast<size_t>(distance / delta); };
+        struct output {
+            std::vector<Vertex> current;
+            std::vector<std::pair<size_t, Vertex>> later;
+        };
+        std::vector<output> outputs(thread_num);
+        std::vector<std::vector<Vertex>> buckets(1, std::vector<Vertex>{source});
+        std::vector<Vertex> frontier, settled;
+        std::vector<char> marked(n);
+        enum { light, heavy, done } phase = heavy;
+        size_t current = 0, next = 0;
+        auto unique_append = [&](std::vector<Vertex>& to, auto&& from, auto valid) {
+            size_t first = to.size();
+            for (auto vtx : from) { if (valid(vtx) and not marked[vtx]) { marked[vtx] = true; to.emplace_back(vtx); } }
+            for (size_t i = first; i < to.size(); ++i) { marked[to[i]] = false; }
+        };
+        auto advance = [&]() noexcept {
+            std::vector<Vertex> next_frontier;
+            for (auto& [same, later] : outputs) {
+                next_frontier.insert(next_frontier.end(), same.begin(), same.end()); same.clear();
+                for (auto [idx, vtx] : later) {
+                    if (idx >= buckets.size()) { buckets.resize(idx + 1); }
+                    buckets[idx].emplace_back(vtx);
+                }
+                later.clear();
+            }
+            if (phase == light) {
+                settled.insert(settled.end(), frontier.begin(), frontier.end());
+                frontier.clear();
+                unique_append(frontier, next_frontier, [](Vertex) { return true; });
+                if (not frontier.empty()) { return; }
+                std::vector<Vertex> all; all.swap(settled);
+                unique_append(settled, all, [](Vertex) { return true; });
+                phase = heavy; return;
+            }
+            settled.clear();
+            for (; next < buckets.size(); ) {
+                current = next++;
+                std::vector<Vertex> bucket; bucket.swap(buckets[current]);
+                unique_append(frontier, bucket, [&](Vertex vtx) { return bucket_of(shortest[vtx]) == current; });
+                if (not frontier.empty()) { phase = light; return; }
+            }
+            phase = done;
+        };
+        std::barrier sync(thread_num, advance);
+        parallel_for(thread_num, [&](size_t idx) {
+            auto& [same, later] = outputs[idx];
+            auto relax = [&](Vertex child, Weight new_distance) {
+                std::atomic_ref<Weight> distance(shortest[child]);
+                for (Weight old = distance.load(std::memory_order_relaxed); new_distance < old;) {
+                    if (not distance.compare_exchange_weak(old, new_distance, std::memory_order_relaxed)) { continue; }
+                    size_t bucket = bucket_of(new_distance);
+                    if (bucket == current) { same.emplace_back(child); }
+                    else { later.emplace_back(bucket, child); }
+                    return;
+                }
+            };
+            while (true) {
+                sync.arrive_and_wait();
+                if (phase == done) { break; }
+                const auto& work = phase == light ? frontier : settled;
+                auto [begin, end] = split_range(work.size(), thread_num, idx);
+                for (size_t i = begin; i < end; ++i) {
+                    Vertex vtx = work[i];
+                    Weight distance = std::atomic_ref<Weight>(shortest[vtx]).load(std::memory_order_relaxed);
+                    for (const auto& edge : graph[vtx]) {
+                        if ((edge.value() <= delta) == (phase == light)) { relax(edge.head(), distance + edge.value()); }
+                    }
+                }
+            }
+        });
+        return shortest;
+    }
+}
+
+namespace lcf {
+    /*
+    * source to target distance, inf if unreachable; reverse_graph holds every edge of graph reversed;
+    * the side with the smaller heap top is expanded, every relaxed edge reaching the other side updates the best path,
+    * which is final once the two heap tops sum to no less than it
+    */
+    template<typename Graph, template <typename...> typename Heap>
+    typename Graph::edge_type::weight_type
+    bidirectional_dijkstra(const Graph& graph, const Graph& reverse_graph, graph::vertex source, graph::vertex target,
+        sssp_workspace<typename Graph::edge_type::weight_type, Heap>& forward,
+        sssp_workspace<typename Graph::edge_type::weight_type, Heap>& backward)
+    {
+        using Edge = typename Graph::edge_type;
+        using Weight = typename Edge::weight_type;
+        forward.start(graph.size(), Edge::inf); backward.start(graph.size(), Edge::inf);
+        forward.set_distance(source, Weight{}); forward.heap.push(std::make_pair(Weight{}, source));
+        backward.set_distance(target, Weight{}); backward.heap.push(std::make_pair(Weight{}, target));
+        Weight best = source == target ? Weight{} : Edge::inf;
+        while (not forward.heap.empty() and not backward.heap.empty()) {
+            if (forward.heap.top().first + backward.heap.top().first >= best) { break; }
+            bool is_forward = forward.heap.top().first <= backward.heap.top().first;
+            auto& self = is_forward ? forward : backward;
+            auto& other = is_forward ? backward : forward;
+            auto [distance, vtx] = self.heap.top(); self.heap.pop();
+            if (self.marked(vtx)) { continue; }
+            else { self.mark(vtx); }
+            for (const auto& edge : (is_forward ? graph : reverse_graph)[vtx]) {
+                graph::vertex child = edge.head();
+                Weight new_distance = distance + edge.value();
+                if (other.touched(child)) { best = std::min(best, new_distance + other.distance(child)); }
+                if (self.marked(child) or self.distance(child) <= new_distance) { continue; }
+                self.set_distance(child, new_distance);
+                self.heap.push(std::make_pair(new_distance, child));
+            }
+        }
+        return best;
+    }
+
+    /*
+    * source to target distance, inf if unreachable; heuristic(vtx) must never exceed the distance from vtx to target,
+    * vertices are reopened when a shorter path is found, so a consistent heuristic is not required
+    */
+    template<typename Graph, typename Heuristic, template <typename...> typename Heap>
+    typename Graph::edge_type::weight_type
+    a_star(const Graph& graph, graph::vertex source, graph::vertex target, Heuristic heuristic,
+        sssp_workspace<typename Graph::edge_type::weight_type, Heap>& workspace)
+    {
+        using Edge = typename Graph::edge_type;
+        using Weight = typename Edge::weight_type;
+        workspace.start(graph.size(), Edge::inf);
+        workspace.set_distance(source, Weight{});
+        workspace.heap.push(std::make_pair(static_cast<Weight>(heuristic(source)), source));
+        while (not workspace.heap.empty()) {
+            graph::vertex vtx = workspace.heap.top().second; workspace.heap.pop();
+            if (vtx == target) { return workspace.distance(target); }
+            for (const auto& edge : graph[vtx]) {
+                graph::vertex child = edge.head();
+                Weight new_distance = workspace.distance(vtx) + edge.value();
+                if (workspace.distance(child) <= new_distance) { continue; }
+                workspace.set_distance(child, new_distance);
+                workspace.heap.push(std::make_pair(new_distance + static_cast<Weight>(heuristic(child)), child));
+            }
+        }
+        return Edge::inf;
+    }
+
+    template <typename Coord>
+    auto manhattan_distance(const Coord& lhs, const Coord& rhs) {
+        auto dx = lhs.first - rhs.first, dy = lhs.second - rhs.second;
+        return (dx < 0 ? -dx : dx) + (dy < 0 ? -dy : dy);
+    }
+    /*
+    * admissible for a_star when every edge weighs at least scale times the manhattan distance of its ends, e.g. on lcf::coord grids;
+    * the heuristic views an lvalue coords through a span, so coords must outlive it, an rvalue coords is moved into it
+    */
+    template <typename Coord, typename Weight = int>
+    auto manhattan_heuristic(const std::vector<Coord>& coords, graph::vertex target, Weight scale = 1) {
+        return [coords = std::span<const Coord>(coords), target, scale](graph::vertex vtx)
+        { return static_cast<Weight>(manhattan_distance(coords[vtx], coords[target])) * scale; };
+    }
+    template <typename Coord, typename Weight = int>
+    auto manhattan_heuristic(std::vector<Coord>&& coords, graph::vertex target, Weight scale = 1) {
+        return [coords = std::move(coords), target, scale](graph::vertex vtx)
+        { return static_cast<Weight>(manhattan_distance(coords[vtx], coords[target])) * scale; };
+    }
+}
+
+namespace lcf {
+    /*
+    * Dial's algorithm for non-negative integer weights: max_weight + 1 circular buckets indexed by distance,
+    * O(V * max_weight + E); stale entries are skipped when the distance no longer matches the bucket
+    */
+    template<typename Graph>
+    std::vector<typename Graph::edge_type::weight_type>
+    dial(const Graph& graph, graph::vertex source) {
+        using Edge = typename Graph::edge_type;
+        using Weight = typename Edge::weight_type;
+        Weight max_weight{};
+        for (graph::vertex vtx = 0, n = graph.size(); vtx < n; ++vtx)
+        { for (const auto& edge : graph[vtx]) { max_weight = std::max(max_weight, edge.value()); } }
+        std::vector<Weight> shortest(graph.size(), Edge::inf); shortest[source] = Weight{};
+        std::vector<std::vector<graph::vertex>> buckets(max_weight + 1);
+        buckets[0].push_back(source);
+        for (Weight distance{}, pending = 1; pending; ++distance) {
+            auto& bucket = buckets[distance % buckets.size()];
+            while (not bucket.empty()) {
+                graph::vertex vtx = bucket.back(); bucket.pop_back(); --pending;
+                if (shortest[vtx] != distance) { continue; }
+                for (const auto& edge : graph[vtx]) {
+                    graph::vertex child = edge.head();
+                    Weight new_distance = distance + edge.value();
+                    if (shortest[child] <= new_distance) { continue; }
+                    shortest[child] = new_distance;
+                    buckets[new_distance % buckets.size()].push_back(child); ++pending;
+                }
             }
         }
         return shortest;
@@ -60,18 +397,17 @@ namespace lcf {
 }
 
 namespace lcf {
-    template<typename Graph, template <typename...> typename Heap = lcf::std_binary_heap>
+    //* weights must be 0 or 1: 0-edges go to the front of the deque and 1-edges to the back
+    template<typename Graph>
     std::vector<typename Graph::edge_type::weight_type>
-    dijkstra(const Graph& graph, graph::vertex source) {
+    zero_one_bfs(const Graph& graph, graph::vertex source) {
         using Edge = typename Graph::edge_type;
         using Weight = typename Edge::weight_type;
-        using Pair = std::pair<Weight, graph::vertex>;
-        std::vector<Weight> shortest(graph.size(), Edge::inf);
+        std::vector<Weight> shortest(graph.size(), Edge::inf); shortest[source] = Weight{};
         std::tr2::dynamic_bitset<> processed(graph.size());
-        Heap<Pair, std::greater<Pair>> small_heap;
-        shortest[source] = Weight{}; small_heap.push(std::make_pair(Weight{}, source));
-        while (not small_heap.empty()) {
-            auto [_, vtx] = small_heap.top(); small_heap.pop();
+        std::deque<graph::vertex> deque; deque.push_back(source);
+        while (not deque.empty()) {
+            graph::vertex vtx = deque.front(); deque.pop_front();
             if (processed[vtx]) { continue; }
             else { processed[vtx] = true; }
             for (const auto& edge : graph[vtx]) {
@@ -79,7 +415,8 @@ namespace lcf {
                 Weight new_distance = shortest[vtx] + edge.value();
                 if (shortest[child] <= new_distance) { continue; }
                 shortest[child] = new_distance;
-                small_heap.push(std::make_pair(new_distance, child));
+                if (edge.value() == Weight{}) { deque.push_front(child); }
+                else { deque.push_back(child); }
             }
         }
         return shortest;
@@ -92,17 +429,45 @@ namespace lcf {
     struct johnson {
         using Vertex = graph::vertex;
         using Weight = typename Graph::edge_type::weight_type;
-        using ShortestPath = decltype(bellman_ford<Graph>);
+        using ShortestPath = std::vector<Weight> (*)(const Graph&, graph::vertex);
         johnson(const Graph& g, ShortestPath shortest_path = bellman_ford<Graph>)
         : graph(g) { init(shortest_path); }
         johnson(Graph&& g, ShortestPath shortest_path = bellman_ford<Graph>)
         : graph(std::move(g)) { init(shortest_path); }
         auto operator[](graph::vertex source) {
-            auto shortest = dijkstra<Graph, Heap>(graph, source);
-            for (Vertex vtx = virtual_vtx + 1, n = graph.size(); vtx < n; ++vtx)
-            { shortest[vtx] += h[vtx] - h[source]; }
+            std::vector<Weight> shortest(graph.size());
+            solve(source, shortest.data(), workspace);
             return  shortest;
         }
+        /*
+        * row i of distances is set to operator[](sources[i]), distances must have graph.size() columns;
+        * sources are taken one at a time by thread_num threads, each with its own workspace
+        */
+        void batch(const std::vector<Vertex>& sources, lcf::matrix<Weight>& distances,
+            size_t thread_num = default_thread_num()) const
+        {
+            std::atomic<size_t> next(0);
+            thread_num = std::clamp<size_t>(thread_num, 1, std::max<size_t>(sources.size(), 1));
+            parallel_for(thread_num, [&](size_t) {
+                sssp_workspace<Weight, Heap> local_workspace(graph.size());
+                for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < sources.size();)
+                { solve(sources[i], &distances(i, 0), local_workspace); }
+            });
+        }
+        //* row virtual_vtx is the distances from virtual_vtx, every other row u is operator[](u)
+        lcf::matrix<Weight> all_pairs(size_t thread_num = default_thread_num()) const {
+            std::vector<Vertex> sources(graph.size());
+            std::iota(sources.begin(), sources.end(), 0);
+            lcf::matrix<Weight> distances(graph.size(), graph.size());
+            batch(sources, distances, thread_num);
+            return distances;
+        }
+        void solve(Vertex source, Weight* row, sssp_workspace<Weight, Heap>& local_workspace) const {
+            dijkstra(graph, source, local_workspace);
+            row[virtual_vtx] = local_workspace.distance(virtual_vtx);
+            for (Vertex vtx = virtual_vtx + 1, n = graph.size(); vtx < n; ++vtx)
+            { row[vtx] = local_workspace.distance(vtx) + h[vtx] - h[source]; }
+        }
         bool has_negative_circle() const { return h.empty(); }
         void init(ShortestPath shortest_path) {
             for (Vertex i = virtual_vtx + 1, n = graph.size(); i < n; ++i)
@@ -119,6 +484,7 @@ namespace lcf {
         static constexpr graph::vertex virtual_vtx = 0;
         Graph graph;
         std::vector<Weight> h;
+        sssp_workspace<Weight, Heap> workspace;
     };
 }
 
@@ -0,0 +1,162 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+#include "graph.h"
+#include "builder.h"
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace lcf {
+    /*
+    * binary snapshot of csr::graph, every section starts at a multiple of alignment:
+    * header | offsets: (vertex_num + 1) x uint64 | heads: edge_num x int32
+    * | weights: edge_num x weight_size | reverse: edge_num x uint64, only if paired
+    */
+    struct snapshot_header {
+        static constexpr char magic_word[8] = {'L', 'C', 'F', 'G', 'R', 'A', 'P', 'H'};
+        static constexpr std::uint32_t current_version = 1;
+        static constexpr std::uint64_t alignment = 64;
+        char magic[8];
+        std::uint32_t version, weight_size;
+        std::uint64_t vertex_num, edge_num, paired;
+        std::uint64_t offsets_pos, heads_pos, weights_pos, reverse_pos;
+    };
+    static_assert(sizeof(size_t) == sizeof(std::uint64_t) and sizeof(graph::vertex) == sizeof(std::int32_t));
+
+    //* a non-owning array in mapped memory, used as the Container of csr::graph
+    template <typename T>
+    class mapped_array {
+    public:
+        using value_type = T;
+        mapped_array(T* data = nullptr, size_t size = 0) : _data(data), _size(size) { }
+        T* data() const { return _data; }
+        size_t size() const { return _size; }
+        bool empty() const { return _size == 0; }
+        T* begin() const { return _data; }
+        T* end() const { return _data + _size; }
+        T& back() const { return _data[_size - 1]; }
+        T& operator[](size_t idx) const { return _data[idx]; }
+    private:
+        T* _data;
+        size_t _size;
+    };
+
+    //* MAP_PRIVATE: clean pages stay shared in the page cache, modified edge values are copied on write
+    class mapped_file {
+    public:
+        mapped_file(const std::string& path) {
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd == -1) { throw std::runtime_error("mapped_file: cannot open " + path); }
+            struct stat status;
+            if (::fstat(fd, &status) == -1) { ::close(fd); throw std::runtime_error("mapped_file: cannot stat " + path); }
+            _size = status.st_size;
+            _data = _size ? ::mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0) : nullptr;
+            ::close(fd);
+            if (_data == MAP_FAILED) { throw std::runtime_error("mapped_file: cannot map " + path); }
+        }
+        mapped_file(mapped_file&& other) noexcept
+        : _data(std::exchange(other._data, nullptr)), _size(std::exchange(other._size, 0)) { }
+        mapped_file(const mapped_file&) = delete;
+        ~mapped_file() { if (_data) { ::munmap(_data, _size); } }
+        char* data() const { return static_cast<char*>(_data); }
+        size_t size() const { return _size; }
+    private:
+        void* _data;
+        size_t _size;
+    };
+}
+
+namespace lcf {
+    //* csr::graph iterating the arrays of a snapshot in place; the mapping lives as long as the graph
+    template <typename Edge>
+    class mapped_graph : private mapped_file, public csr::graph<Edge, mapped_array> {
+        using _Base = csr::graph<Edge, mapped_array>;
+    public:
+        using storage_type = typename _Base::storage_type;
+        using _Base::size;
+        mapped_graph(const std::string& path) : mapped_file(path), _Base(load(static_cast<const mapped_file&>(*this))) { }
+        mapped_graph(mapped_graph&& other) = default;
+    private:
+        //* static: it runs in a base initializer, before the graph itself exists
+        static _Base load(const mapped_file& file) {
+            if (file.size() < sizeof(snapshot_header)) { throw std::runtime_error("mapped_graph: truncated snapshot"); }
+            const auto& header = *reinterpret_cast<const snapshot_header*>(file.data());
+            if (std::memcmp(header.magic, snapshot_header::magic_word, sizeof(header.magic)))
+            { throw std::runtime_error("mapped_graph: not a graph snapshot"); }
+            if (header.version != snapshot_header::current_version)
+            { throw std::runtime_error("mapped_graph: unsupported snapshot version"); }
+            if (header.weight_size != (_Base::weighted ? sizeof(storage_type) : 0))
+            { throw std::runtime_error("mapped_graph: weight type mismatch"); }
+            size_t n = header.vertex_num, m = header.edge_num;
+            if (n >= static_cast<size_t>(std::numeric_limits<graph::vertex>::max()))
+            { throw std::runtime_error("mapped_graph: corrupt snapshot header"); }
+            size_t end = sizeof(snapshot_header);
+            //* sections are aligned, in order and inside the file, count * size is compared without overflow
+            auto check = [&](std::uint64_t pos, size_t count, size_t size) {
+                if (pos % snapshot_header::alignment or pos < end or pos > file.size() or count > (file.size() - pos) / size)
+                { throw std::runtime_error("mapped_graph: corrupt snapshot header"); }
+                end = pos + count * size;
+            };
+            check(header.offsets_pos, n + 1, sizeof(size_t));
+            check(header.heads_pos, m, sizeof(graph::vertex));
+            if (header.weight_size) { check(header.weights_pos, m, header.weight_size); }
+            if (header.paired) { check(header.reverse_pos, m, sizeof(size_t)); }
+            mapped_array<size_t> offsets(section<size_t>(file, header.offsets_pos), n + 1);
+            if (offsets[0] != 0 or offsets[n] != m) { throw std::runtime_error("mapped_graph: corrupt snapshot offsets"); }
+            for (size_t u = 0; u < n; ++u)
+            { if (offsets[u] > offsets[u + 1]) { throw std::runtime_error("mapped_graph: corrupt snapshot offsets"); } }
+            return _Base(std::move(offsets),
+                mapped_array<graph::vertex>(section<graph::vertex>(file, header.heads_pos), m),
+                mapped_array<storage_type>(_Base::weighted ? section<storage_type>(file, header.weights_pos) : nullptr, _Base::weighted ? m : 0),
+                mapped_array<size_t>(header.paired ? section<size_t>(file, header.reverse_pos) : nullptr, header.paired ? m : 0));
+        }
+        template <typename T>
+        static T* section(const mapped_file& file, size_t pos) { return reinterpret_cast<T*>(file.data() + pos); }
+    };
+}
+
+namespace lcf {
+    //* cfs::graph and al::graph are converted to csr::graph first; the pairing of cfs::graph is kept
+    template <typename Graph>
+    void save_snapshot(const Graph& g, const std::string& path) {
+        if constexpr (not builder::is_csr<Graph>::value) {
+            save_snapshot(csr::graph<typename csr::edge_of<typename Graph::edge_type>::type>(g), path);
+        } else {
+            using Storage = typename Graph::storage_type;
+            static_assert(std::is_trivially_copyable_v<Storage>, "snapshot weights must be trivially copyable");
+            auto align = [](std::uint64_t pos) { return (pos + snapshot_header::alignment - 1) / snapshot_header::alignment * snapshot_header::alignment; };
+            snapshot_header header{};
+            std::memcpy(header.magic, snapshot_header::magic_word, sizeof(header.magic));
+            header.version = snapshot_header::current_version;
+            header.weight_size = Graph::weighted ? sizeof(Storage) : 0;
+            header.vertex_num = g.size(); header.edge_num = g.edge_size(); header.paired = g.paired();
+            header.offsets_pos = align(sizeof(snapshot_header));
+            header.heads_pos = align(header.offsets_pos + (header.vertex_num + 1) * sizeof(size_t));
+            header.weights_pos = align(header.heads_pos + header.edge_num * sizeof(graph::vertex));
+            header.reverse_pos = align(header.weights_pos + header.edge_num * header.weight_size);
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+            if (not file) { throw std::runtime_error("save_snapshot: cannot open " + path); }
+            auto write = [&file](std::uint64_t pos, const void* data, size_t size) {
+                static constexpr char padding[snapshot_header::alignment] = {};
+                file.write(padding, pos - file.tellp());
+                file.write(static_cast<const char*>(data), size);
+            };
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            write(header.offsets_pos, g.offset_list().data(), (header.vertex_num + 1) * sizeof(size_t));
+            write(header.heads_pos, g.head_list().data(), header.edge_num * sizeof(graph::vertex));
+            if constexpr (Graph::weighted) { write(header.weights_pos, g.weight_list().data(), header.edge_num * sizeof(Storage)); }
+            if (header.paired) { write(header.reverse_pos, g.reverse_list().data(), header.edge_num * sizeof(size_t)); }
+            if (not file) { throw std::runtime_error("save_snapshot: cannot write " + path); }
+        }
+    }
+}
+
+#endif